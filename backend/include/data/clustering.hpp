@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Edge of the correlation minimum spanning tree
+ */
+struct TreeEdge
+{
+	std::size_t a;
+	std::size_t b;
+	float distance;    /**< Correlation distance sqrt(2(1 - correlation)) */
+};
+
+/**
+ *  Weighted undirected edge of a sparse graph
+ */
+struct WeightedEdge
+{
+	std::size_t a;
+	std::size_t b;
+	float weight;
+};
+
+/**
+ *  Converts a correlation to the Mantegna distance sqrt(2(1 - correlation)), in [0, 2]
+ */
+float correlationDistance(float correlation);
+
+/**
+ *  Computes the minimum spanning tree of the correlation distances with
+ *  Prim's algorithm on the dense matrix, O(N^2) time without an edge list
+ * @param correlations Row-major N x N correlation matrix
+ * @param n Number of rows
+ * @return N-1 tree edges in the order they were added
+ */
+std::vector<TreeEdge> computeMinimumSpanningTree(const std::vector<float>& correlations, std::size_t n);
+
+/**
+ *  Average-linkage hierarchical clustering of the correlation distances
+ *  with the nearest-neighbour chain algorithm (O(N^2) time), cut at a
+ *  distance threshold
+ * @param correlations Row-major N x N correlation matrix
+ * @param n Number of rows
+ * @param maxDistance Clusters whose average distance is at most this are merged
+ * @return Cluster id of every row, ids are numbered in order of first appearance
+ */
+std::vector<int> computeHierarchicalClusters(
+		const std::vector<float>& correlations,
+		std::size_t n,
+		float maxDistance);
+
+/**
+ *  Louvain modularity communities of a weighted graph, edges with a
+ *  non-positive weight are ignored
+ * @param n Number of nodes
+ * @param edges Undirected edges
+ * @return Community id of every node, ids are numbered in order of first appearance
+ */
+std::vector<int> computeLouvainCommunities(std::size_t n, const std::vector<WeightedEdge>& edges);
+}
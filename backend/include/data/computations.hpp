@@ -1,6 +1,7 @@
 #pragma once
 #include "table.hpp"
 #include "tools/tools.hpp"
+#include "requests/tokenPriceOHLCV.hpp"
 
 #include <vector>
 #include <string>
@@ -17,9 +18,90 @@ std::vector<float> computeLogReturns(
 		const table::Table& t,
 		const std::string& columnName);
 
+/**
+ *  Computes log returns of the mid price ((high+low)/2) of consecutive bars
+ * @param bars Bars sorted by time
+ * @return Vector of pairs containing bar timestamp and log return
+ */
+std::vector<std::pair<std::size_t, float>> computeMidPriceLogReturns(
+		const std::vector<requests::OHLC>& bars);
+
+/**
+ *  Options of the log returns graph generation
+ */
+struct GraphOptions
+{
+	/**
+	 *  Bar intervals to build a graph for. Prices are fetched once at the
+	 *  finest interval and coarser ones are resampled from it, so every
+	 *  interval must be a multiple of the finest one. The first graph is
+	 *  written to the given path, the others next to it as <name>_<interval>.json
+	 */
+	std::vector<std::string> horizons = {"12h"};
+
+	int nbOfTokens = 100;           /**< Number of top liquidity tokens in the graph */
+
+	/**
+	 *  Links every token only to its most correlated tokens found with an
+	 *  approximate nearest-neighbour search instead of to every other token,
+	 *  for universes too large for all pairs. The share of the exact top
+	 *  neighbours that was found is written as "annRecall".
+	 */
+	bool approximate = false;
+	std::size_t approximateNeighbours = 10; /**< Neighbours linked per token in approximate mode */
+
+	/**
+	 *  Adds "leadLagLinks", directed edges from a leading to a following
+	 *  token with the lag (in intervals) of their strongest cross-correlation.
+	 *  Every pair is searched, in approximate mode only the linked pairs.
+	 */
+	bool leadLag = false;
+	int maxLag = 10;                /**< Largest lag searched, in intervals */
+	float leadLagThreshold = 0.2f;  /**< Smallest cross-correlation that yields a lead/lag edge */
+	double leadLagPValue = 1e-3;    /**< Chance that independent tokens get an edge, raises the threshold of short horizons */
+
+	/**
+	 *  Adds x/y/z to every node from a 3D force-directed layout where
+	 *  positively correlated tokens attract each other. The layout starts
+	 *  from the positions in the previous output file so it stays stable.
+	 */
+	bool layout = false;
+
+	/**
+	 *  Adds a "cluster" (average-linkage hierarchical clustering cut at
+	 *  clusterDistance) and a "community" (Louvain on the links of at least
+	 *  communityThreshold correlation) to every node, and the correlation
+	 *  minimum spanning tree as "backbone". Clusters and the backbone need
+	 *  every pair, so approximate mode only adds communities.
+	 */
+	bool clustering = false;
+	float clusterDistance = 1.2f;   /**< Largest sqrt(2(1 - correlation)) distance within a cluster */
+	float communityThreshold = 0.2f; /**< Smallest correlation of a link used for communities */
+
+	/**
+	 *  Adds the "loadings" and "idiosyncraticVariance" of a low-rank factor
+	 *  model to every node, so clients can rebuild any correlation in
+	 *  O(nbOfFactors), and "factors" with the variance of every factor.
+	 *  Links get a "residualCorrelation" with the market mode (first factor)
+	 *  removed.
+	 */
+	bool factorModel = false;
+	std::size_t nbOfFactors = 5;    /**< Number of factors of the model */
+
+	/**
+	 *  Adds "holderLinks" between tokens sharing top holders, weighted by
+	 *  the Jaccard similarity of their holder sets estimated with MinHash.
+	 *  Only pairs found through LSH banding are compared.
+	 */
+	bool holderSimilarity = false;
+	int nbOfHolders = 100;          /**< Top holders fetched per token */
+	float holderSimilarityThreshold = 0.2f; /**< Smallest estimated Jaccard similarity that yields a link */
+};
+
 /**
  *  Generates data for graph visualization of log returns
- * @param filePath Path to the output CSV file
+ * @param filePath Path to the output JSON file
+ * @param options Generation options
  */
-void generateLogReturnsGraph(std::string filePath);
+void generateLogReturnsGraph(std::string filePath, const GraphOptions& options = {});
 }
@@ -0,0 +1,59 @@
+#pragma once
+#include "data/returnMatrix.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Undirected pair of matrix rows with their correlation
+ */
+struct CorrelationEdge
+{
+	std::size_t a;     /**< Smaller row index */
+	std::size_t b;     /**< Larger row index */
+	float correlation; /**< Dot product of the standardized rows */
+};
+
+/**
+ *  Parameters of the approximate nearest-neighbour correlation search
+ */
+struct NeighbourSearchOptions
+{
+	std::size_t neighbours = 10;            /**< Strongest correlations kept per row */
+	std::size_t dimensions = 64;            /**< Size of the random projection embedding */
+	std::size_t connections = 16;           /**< Links per node and layer of the HNSW graph */
+	std::size_t efConstruction = 100;       /**< Candidate list size while building the graph */
+	std::size_t efSearch = 64;              /**< Candidate list size while searching the graph */
+	std::size_t candidatesPerNeighbour = 4; /**< Rows scored exactly per kept neighbour */
+	std::size_t recallSampleSize = 64;      /**< Rows checked against an exact search */
+	std::uint64_t seed = 42;                /**< Seed of the random projections */
+};
+
+/**
+ *  Result of the approximate nearest-neighbour correlation search
+ */
+struct NeighbourSearchResult
+{
+	std::vector<CorrelationEdge> edges; /**< Unique pairs, each in some row's top neighbours */
+	float recall = 1;                   /**< Share of the exact top neighbours found, over the sample */
+	std::size_t nbOfCandidates = 0;     /**< Number of exact correlations computed */
+};
+
+/**
+ *  Finds the most correlated rows (by absolute correlation) of every row
+ *  without comparing all pairs. Rows are embedded with Gaussian random
+ *  projections and indexed in an HNSW graph; every row is searched as is
+ *  and negated to find both signs of correlation. Only the best candidates
+ *  of the embedding get an exact correlation, so the search is O(N log N)
+ *  in the number of rows for a fixed number of neighbours.
+ * @param matrix Standardized return matrix
+ * @param options Search parameters
+ * @return Neighbour edges and the measured recall
+ */
+NeighbourSearchResult findCorrelatedNeighbours(
+		const ReturnMatrix& matrix,
+		const NeighbourSearchOptions& options = {});
+}
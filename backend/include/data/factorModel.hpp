@@ -0,0 +1,94 @@
+#pragma once
+#include "data/returnMatrix.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Parameters of the randomized factor decomposition
+ */
+struct FactorModelOptions
+{
+	std::size_t factors = 5;         /**< Number of factors kept */
+	std::size_t oversampling = 10;   /**< Extra random directions sampled beyond the kept factors */
+	std::size_t powerIterations = 2; /**< Subspace iterations, sharpen the spectrum when it decays slowly */
+	std::uint64_t seed = 42;         /**< Seed of the random test matrix */
+};
+
+/**
+ *  Low-rank approximation of a correlation matrix: every series has k
+ *  factor loadings and an idiosyncratic variance, so a correlation costs
+ *  O(k) and the model is stored in O(N k) instead of O(N^2)
+ */
+class FactorModel
+{
+	public:
+		FactorModel() = default;
+
+		/**
+		 *  Creates a model from its loadings
+		 * @param loadings Row-major nbOfSeries x eigenvalues.size() loadings
+		 * @param eigenvalues Variance explained by every factor, largest first
+		 * @param idiosyncraticVariances Variance of every series not explained by the factors
+		 * @param totalVariance Sum of the variances of all series
+		 */
+		FactorModel(
+				std::vector<float> loadings,
+				std::vector<float> eigenvalues,
+				std::vector<float> idiosyncraticVariances,
+				float totalVariance);
+
+		std::size_t nbOfSeries() const { return m_idiosyncraticVariances.size(); }
+		std::size_t nbOfFactors() const { return m_eigenvalues.size(); }
+
+		/**
+		 *  Gets the factor loadings of one series
+		 */
+		std::span<const float> getLoadings(std::size_t i) const;
+
+		float getIdiosyncraticVariance(std::size_t i) const;
+		const std::vector<float>& getEigenvalues() const { return m_eigenvalues; }
+
+		/**
+		 *  Gets the share of the total variance explained by the factors
+		 */
+		float getExplainedVariance() const;
+
+		/**
+		 *  Approximates the correlation of two series from their loadings
+		 */
+		float correlation(std::size_t i, std::size_t j) const;
+
+		/**
+		 *  Removes the first factors (the market mode) from a correlation of
+		 *  the two series, giving their partial correlation given those factors
+		 * @param i First series
+		 * @param j Second series
+		 * @param correlation Correlation of the series, exact or approximated
+		 * @param nbOfRemovedFactors Number of leading factors removed
+		 * @return Residual correlation, 0 when a series is fully explained by the removed factors
+		 */
+		float residualCorrelation(std::size_t i, std::size_t j, float correlation, std::size_t nbOfRemovedFactors = 1) const;
+
+	private:
+		std::vector<float> m_loadings;
+		std::vector<float> m_eigenvalues;
+		std::vector<float> m_idiosyncraticVariances;
+		float m_totalVariance = 0;
+};
+
+/**
+ *  Computes the leading eigenvectors of the correlation matrix of the rows
+ *  with a randomized SVD of the return matrix (Halko, Martinsson & Tropp),
+ *  without forming the N x N correlation matrix. The cost is
+ *  O(N T (k + oversampling) (1 + powerIterations)) for N rows of T samples.
+ * @param matrix Standardized return matrix
+ * @param options Decomposition parameters
+ * @return Factor model of the rows, loadings are eigenvectors scaled by sqrt(eigenvalue)
+ */
+FactorModel computeFactorModel(const ReturnMatrix& matrix, const FactorModelOptions& options = {});
+}
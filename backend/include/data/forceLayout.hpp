@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Position of a node in 3D space
+ */
+struct Position
+{
+	float x = 0;
+	float y = 0;
+	float z = 0;
+};
+
+/**
+ *  Spring between two nodes of the layout
+ */
+struct LayoutEdge
+{
+	std::size_t source;
+	std::size_t target;
+	float weight;       /**< In (0, 1], stronger edges are shorter and stiffer */
+};
+
+/**
+ *  Parameters of the force simulation, defaults follow d3-force-3d so the
+ *  result looks like what the frontend would have settled on
+ */
+struct LayoutOptions
+{
+	std::size_t iterations = 300;   /**< Ticks of a cold start, the cooling schedule spans them */
+	float warmStartAlpha = 0.05f;   /**< Initial temperature when at least half of the nodes have a previous position, like d3's reheat */
+	float anchorStrength = 0.1f;    /**< Stiffness of the spring pulling a warm started node back to its previous position */
+	float minKineticEnergy = 1e-3f; /**< Mean squared speed per tick below which the simulation stops before the schedule ends */
+	float charge = -30.0f;          /**< Many-body strength, negative repels */
+	float theta = 0.9f;             /**< Barnes-Hut opening criterion */
+	float linkDistance = 30.0f;     /**< Rest length of an edge of weight 0 */
+	float velocityDecay = 0.4f;     /**< Share of velocity lost per tick */
+	std::uint64_t seed = 42;        /**< Seed of the placement of new nodes */
+};
+
+/**
+ *  Computes a 3D force-directed layout. Repulsion between all nodes is
+ *  approximated with a Barnes-Hut octree, forces are evaluated in parallel.
+ *  Nodes with a previous position start there, new nodes start next to
+ *  their most strongly linked placed neighbour. A warm start runs cooler,
+ *  keeps a weak spring to the previous positions and stops once the nodes
+ *  barely move, so consecutive layouts stay close to each other.
+ * @param nbOfNodes Number of nodes
+ * @param edges Springs between nodes
+ * @param previous Previous position of every node, if any
+ * @param options Simulation parameters
+ * @return Position of every node
+ */
+std::vector<Position> computeForceLayout(
+		std::size_t nbOfNodes,
+		const std::vector<LayoutEdge>& edges,
+		const std::vector<std::optional<Position>>& previous,
+		const LayoutOptions& options = {});
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "data/returnMatrix.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Directed relation where the leader's returns anticipate the follower's
+ */
+struct LeadLagEdge
+{
+	std::size_t leader;   /**< Row of the leading series */
+	std::size_t follower; /**< Row of the following series */
+	int lag;              /**< Number of intervals the leader is ahead */
+	float correlation;    /**< Cross-correlation at that lag */
+};
+
+/**
+ *  Finds lead/lag relations between every pair of series of a matrix.
+ *  Each row is transformed once with an FFT, then each pair's full
+ *  cross-correlation function costs one inverse FFT, O(T log T).
+ *  A pair yields an edge when its strongest cross-correlation within
+ *  maxLag is not at lag 0 and its magnitude is at least minCorrelation
+ *  and significant: independent series of n overlapping samples exceed
+ *  z / sqrt(n - lag) at any of the 2 maxLag + 1 lags with probability
+ *  pValue, so short series need much stronger peaks.
+ * @param matrix Standardized return matrix
+ * @param maxLag Largest lag (in intervals) searched for a peak
+ * @param minCorrelation Smallest peak magnitude that yields an edge
+ * @param pValue Chance that a pair of independent series yields an edge
+ * @return Lead/lag edges ordered by leader/follower pair
+ */
+std::vector<LeadLagEdge> computeLeadLag(
+		const ReturnMatrix& matrix,
+		int maxLag,
+		float minCorrelation,
+		double pValue = 1e-3);
+
+/**
+ *  Finds lead/lag relations between the given pairs of series only, e.g.
+ *  the approximate nearest neighbours, in O(P T log T) for P pairs
+ * @param matrix Standardized return matrix
+ * @param pairs Rows to compare, in any order, duplicates are ignored
+ * @param maxLag Largest lag (in intervals) searched for a peak
+ * @param minCorrelation Smallest peak magnitude that yields an edge
+ * @param pValue Chance that a pair of independent series yields an edge
+ * @return Lead/lag edges ordered by leader/follower pair
+ */
+std::vector<LeadLagEdge> computeLeadLag(
+		const ReturnMatrix& matrix,
+		const std::vector<std::pair<std::size_t, std::size_t>>& pairs,
+		int maxLag,
+		float minCorrelation,
+		double pValue = 1e-3);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Parameters of the MinHash similarity search
+ */
+struct MinHashOptions
+{
+	std::size_t nbOfHashes = 128;   /**< Sketch length, the Jaccard estimate has a standard error of about 1/sqrt(nbOfHashes) */
+	std::size_t nbOfBands = 64;     /**< LSH bands, pairs sharing a band become candidates; must divide nbOfHashes */
+	float minSimilarity = 0.2f;     /**< Smallest estimated Jaccard similarity kept, candidates are found with probability 0.93 at 0.2 */
+	std::uint64_t seed = 42;        /**< Seed of the hash functions */
+};
+
+/**
+ *  Pair of sets with their estimated Jaccard similarity
+ */
+struct SimilarityEdge
+{
+	std::size_t a;     /**< Smaller set index */
+	std::size_t b;     /**< Larger set index */
+	float jaccard;     /**< Share of equal sketch values */
+};
+
+/**
+ *  MinHash sketches of many sets, one row of nbOfHashes values per set
+ */
+struct MinHashSketches
+{
+	std::size_t nbOfHashes = 0;
+	std::vector<std::uint64_t> values;  /**< Row-major nbOfSets x nbOfHashes minimum hashes */
+	std::vector<std::size_t> sizes;     /**< Number of items of every set, empty sets never match */
+
+	std::size_t nbOfSets() const { return sizes.size(); }
+
+	std::span<const std::uint64_t> sketch(std::size_t i) const
+	{
+		return {values.data() + i * nbOfHashes, nbOfHashes};
+	}
+};
+
+/**
+ *  Sketches every set: items are hashed once with FNV-1a, then every hash
+ *  function is a seeded mix of that hash and keeps its minimum over the set
+ * @param sets Items of every set, duplicates do not matter
+ * @param nbOfHashes Sketch length
+ * @param seed Seed of the hash functions
+ * @return Sketches in O(nbOfSets nbOfHashes) memory
+ */
+MinHashSketches computeMinHashSketches(
+		const std::vector<std::vector<std::string>>& sets,
+		std::size_t nbOfHashes,
+		std::uint64_t seed = 42);
+
+/**
+ *  Estimates the Jaccard similarity of two sets from their sketches
+ */
+float estimateJaccard(const MinHashSketches& sketches, std::size_t a, std::size_t b);
+
+/**
+ *  Finds the pairs of sets with a large Jaccard similarity. Sketches are
+ *  split into bands and only sets that agree on a whole band are compared,
+ *  so a pair of similarity s is a candidate with probability
+ *  1 - (1 - s^r)^nbOfBands for r = nbOfHashes / nbOfBands.
+ * @param sets Items of every set
+ * @param options Sketch and banding parameters
+ * @return Pairs with an estimated similarity of at least minSimilarity
+ */
+std::vector<SimilarityEdge> findSimilarSets(
+		const std::vector<std::vector<std::string>>& sets,
+		const MinHashOptions& options = {});
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "requests/tokenPriceOHLCV.hpp"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Converts an interval string such as "4h", "12h", "1d" or "1w" to seconds
+ * @param interval Number followed by one of m (minutes), h, d or w
+ * @return Interval length in seconds
+ * @throws std::invalid_argument for malformed or calendar (month) intervals
+ */
+std::size_t intervalToSeconds(const std::string& interval);
+
+/**
+ *  Aggregates bars into coarser buckets (open = first, close = last,
+ *  high = max, low = min, volume = sum). Buckets of a whole number of days
+ *  start on Mondays 00:00 UTC, shorter ones on multiples of the interval
+ *  since the epoch. When the source interval is given, buckets missing any
+ *  of their intervalSeconds / sourceIntervalSeconds bars are dropped, so
+ *  gaps and the still open last bucket never yield truncated bars.
+ * @param bars Source bars sorted by time
+ * @param intervalSeconds Target bucket length in seconds
+ * @param sourceIntervalSeconds Interval of the source bars, 0 keeps partial buckets
+ * @return One bar per kept bucket, stamped with the bucket start
+ * @throws std::invalid_argument if the interval is 0 or not a multiple of the source interval
+ */
+std::vector<requests::OHLC> resampleOHLC(
+		const std::vector<requests::OHLC>& bars,
+		std::size_t intervalSeconds,
+		std::size_t sourceIntervalSeconds = 0);
+
+/**
+ *  Set of OHLC series at several intervals derived from a single fetched series
+ */
+class OHLCPyramid
+{
+	public:
+		/**
+		 *  Constructs a pyramid from the finest available bars
+		 * @param bars Bars sorted by time
+		 * @param intervalSeconds Interval of the given bars in seconds
+		 */
+		OHLCPyramid(std::vector<requests::OHLC> bars, std::size_t intervalSeconds);
+
+		/**
+		 *  Gets the bars at a given interval, building the level on first use
+		 *  from the coarsest existing level whose interval divides it. Only
+		 *  complete buckets are kept, see resampleOHLC
+		 * @param intervalSeconds Interval in seconds, a multiple of the base interval
+		 * @return Bars at the requested interval
+		 */
+		const std::vector<requests::OHLC>& getLevel(std::size_t intervalSeconds);
+
+		/**
+		 *  Gets the interval of the finest level
+		 * @return Base interval in seconds
+		 */
+		std::size_t getBaseInterval() const;
+
+	private:
+		std::size_t m_baseInterval;
+		std::map<std::size_t, std::vector<requests::OHLC>> m_levels;
+};
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include "table.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace query
+{
+
+/**
+ *  Ascending row indices of a table that passed one or more filters
+ */
+using Selection = std::vector<std::uint32_t>;
+
+enum class Compare {
+	Less,
+	LessEqual,
+	Greater,
+	GreaterEqual,
+	Equal,
+	NotEqual
+};
+
+enum class Aggregate {
+	Count,
+	Sum,
+	Mean,
+	Min,
+	Max,
+	StdDev
+};
+
+enum class TimeUnit {
+	Second,
+	Minute,
+	Hour,
+	Day,
+	Week,
+	Month,
+	Year
+};
+
+/**
+ *  Result of a group-by, one entry per distinct key in order of first appearance
+ */
+struct GroupedColumn
+{
+	std::vector<std::string> keys;
+	std::vector<float> values;
+	std::vector<std::size_t> counts;
+};
+
+/**
+ *  Result of a time resampling, one entry per non-empty bucket in time order
+ */
+struct ResampledColumn
+{
+	std::vector<std::int64_t> bucketStarts; /**< Bucket start as epoch seconds */
+	std::vector<float> values;
+	std::vector<std::size_t> counts;
+};
+
+/**
+ *  Selects rows whose numeric value compares true against a constant
+ * @param t Source data table
+ * @param columnName Name of a float or int column
+ * @param op Comparison applied as (cell op value)
+ * @param value Constant to compare with
+ * @param selection Optional selection to refine, nullptr means all rows
+ * @return Selection of matching rows
+ */
+Selection filter(
+		const table::Table& t,
+		const std::string& columnName,
+		Compare op,
+		float value,
+		const Selection* selection = nullptr);
+
+/**
+ *  Selects rows whose string value is equal to a constant
+ * @param t Source data table
+ * @param columnName Name of a string column
+ * @param value Constant to compare with
+ * @param selection Optional selection to refine, nullptr means all rows
+ * @return Selection of matching rows
+ */
+Selection filterEqual(
+		const table::Table& t,
+		const std::string& columnName,
+		const std::string& value,
+		const Selection* selection = nullptr);
+
+/**
+ *  Intersects two selections (logical AND of their filters)
+ */
+Selection intersect(const Selection& a, const Selection& b);
+
+/**
+ *  Unites two selections (logical OR of their filters)
+ */
+Selection unite(const Selection& a, const Selection& b);
+
+/**
+ *  Aggregates a numeric column into a single value
+ * @param t Source data table
+ * @param columnName Name of a float or int column
+ * @param op Aggregate to compute
+ * @param selection Optional selection of rows, nullptr means all rows
+ * @return Aggregated value, NaN for Mean/Min/Max/StdDev over no rows
+ */
+float aggregate(
+		const table::Table& t,
+		const std::string& columnName,
+		Aggregate op,
+		const Selection* selection = nullptr);
+
+/**
+ *  Hash group-by of a numeric column over a string or int key column
+ * @param t Source data table
+ * @param keyColumnName Name of a string or int column used as key
+ * @param valueColumnName Name of a float or int column to aggregate
+ * @param op Aggregate computed per group
+ * @param selection Optional selection of rows, nullptr means all rows
+ * @return Grouped keys with their aggregated values
+ */
+GroupedColumn groupBy(
+		const table::Table& t,
+		const std::string& keyColumnName,
+		const std::string& valueColumnName,
+		Aggregate op,
+		const Selection* selection = nullptr);
+
+/**
+ *  Resamples a numeric column into fixed calendar buckets of a time column
+ * @param t Source data table
+ * @param timeColumnName Name of the time column (see toEpochSeconds)
+ * @param valueColumnName Name of a float or int column to aggregate
+ * @param unit Calendar unit of a bucket
+ * @param step Number of units per bucket
+ * @param op Aggregate computed per bucket
+ * @param selection Optional selection of rows, nullptr means all rows
+ * @return Aggregated value per non-empty bucket
+ */
+ResampledColumn resample(
+		const table::Table& t,
+		const std::string& timeColumnName,
+		const std::string& valueColumnName,
+		TimeUnit unit,
+		int step,
+		Aggregate op,
+		const Selection* selection = nullptr);
+
+/**
+ *  Converts a time column to epoch seconds
+ *  Int and float columns are taken as epoch seconds, string columns are
+ *  parsed as "YYYY-MM-DD" optionally followed by " HH:MM:SS" or "THH:MM:SS"
+ * @param t Source data table
+ * @param columnName Name of the time column
+ * @return Epoch seconds per row
+ */
+std::vector<std::int64_t> toEpochSeconds(
+		const table::Table& t,
+		const std::string& columnName);
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "requests/tokenPriceOHLCV.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Branch-free natural logarithm that vectorizes when used inside loops.
+ *  x is split into m * 2^e with m in [sqrt(1/2), sqrt(2)) and log(m) is
+ *  evaluated as 2*atanh(s), s = (m-1)/(m+1), with |s| <= 0.1716.
+ *  Accuracy for positive normal x: within 2 ulp of std::log, and for
+ *  x in [0.5, 2] (the range of log returns) the absolute error is below
+ *  6e-8. Returns -inf for 0, +inf for +inf and NaN for negative or NaN
+ *  input; subnormal input is out of range.
+ */
+inline float fastLog(float x)
+{
+	constexpr std::uint32_t sqrtHalf = 0x3f3504f3u;
+	const std::uint32_t bits = std::bit_cast<std::uint32_t>(x) - sqrtHalf;
+	const float e = static_cast<float>(static_cast<std::int32_t>(bits) >> 23);
+	const float m = std::bit_cast<float>((bits & 0x007fffffu) + sqrtHalf);
+
+	const float s = (m - 1.0f) / (m + 1.0f);
+	const float s2 = s * s;
+	const float p = s2 * (2.0f / 3 + s2 * (2.0f / 5 + s2 * (2.0f / 7 + s2 * (2.0f / 9))));
+	const float r = (s * p + 2.0f * s) + e * 0.693147180559945309f;
+
+	// Special values are blended in with bit masks, a floating point select
+	// would be kept as a branch and stop the loop from vectorizing
+	constexpr float inf = std::numeric_limits<float>::infinity();
+	const std::uint32_t valid = 0u - static_cast<std::uint32_t>((x > 0.0f) & (x < inf));
+	const std::uint32_t zero = 0u - static_cast<std::uint32_t>(x == 0.0f);
+	const std::uint32_t infinite = 0u - static_cast<std::uint32_t>(x == inf);
+	const std::uint32_t special = (zero & 0xff800000u) | (infinite & 0x7f800000u) | (~(zero | infinite) & 0x7fc00000u);
+	return std::bit_cast<float>((std::bit_cast<std::uint32_t>(r) & valid) | (special & ~valid));
+}
+
+/**
+ *  Double precision variant of fastLog, within 2 ulp of std::log for
+ *  positive normal x (absolute error below 1.3e-16 on [0.5, 2]), same
+ *  special values
+ */
+inline double fastLog(double x)
+{
+	constexpr std::uint64_t sqrtHalf = 0x3fe6a09e667f3bcdull;
+	const std::uint64_t bits = std::bit_cast<std::uint64_t>(x) - sqrtHalf;
+	const double e = static_cast<double>(static_cast<std::int64_t>(bits) >> 52);
+	const double m = std::bit_cast<double>((bits & 0x000fffffffffffffull) + sqrtHalf);
+
+	const double s = (m - 1.0) / (m + 1.0);
+	const double s2 = s * s;
+	const double p = s2 * (2.0 / 3 + s2 * (2.0 / 5 + s2 * (2.0 / 7 + s2 * (2.0 / 9 + s2 * (2.0 / 11
+			+ s2 * (2.0 / 13 + s2 * (2.0 / 15 + s2 * (2.0 / 17 + s2 * (2.0 / 19 + s2 * (2.0 / 21))))))))));
+	const double r = (s * p + 2.0 * s) + e * 0.693147180559945309417;
+
+	constexpr double inf = std::numeric_limits<double>::infinity();
+	const std::uint64_t valid = 0ull - static_cast<std::uint64_t>((x > 0.0) & (x < inf));
+	const std::uint64_t zero = 0ull - static_cast<std::uint64_t>(x == 0.0);
+	const std::uint64_t infinite = 0ull - static_cast<std::uint64_t>(x == inf);
+	const std::uint64_t special = (zero & 0xfff0000000000000ull) | (infinite & 0x7ff0000000000000ull)
+			| (~(zero | infinite) & 0x7ff8000000000000ull);
+	return std::bit_cast<double>((std::bit_cast<std::uint64_t>(r) & valid) | (special & ~valid));
+}
+
+/**
+ *  Several series stored back to back in one buffer, series i is
+ *  values[offsets[i], offsets[i+1])
+ */
+template<typename T>
+struct SeriesBatch
+{
+	std::vector<std::size_t> offsets = {0};
+	std::vector<T> values;
+
+	/**
+	 *  Gets the number of series in the batch
+	 */
+	std::size_t size() const { return offsets.size() - 1; }
+
+	/**
+	 *  Gets one series of the batch
+	 */
+	std::span<const T> operator[](std::size_t i) const
+	{
+		return {values.data() + offsets[i], offsets[i+1] - offsets[i]};
+	}
+};
+
+/**
+ *  Computes log(prices[i+1]/prices[i]) of consecutive prices with fastLog
+ * @param prices Price series
+ * @param out Preallocated output of size prices.size()-1 (ignored when prices has less than 2 values)
+ * @throws std::invalid_argument if out is smaller than prices.size()-1
+ */
+template<typename T>
+void computeLogReturns(std::span<const T> prices, std::span<T> out);
+
+/**
+ *  Gathers the mid prices of many bar series into one batch
+ * @param series Bar series, one per token
+ * @return Batch with one mid price series per input series
+ */
+template<typename T>
+SeriesBatch<T> batchMidPrices(const std::vector<const std::vector<requests::OHLC>*>& series);
+
+/**
+ *  Gathers the close prices of many bar series into one batch
+ * @param series Bar series, one per token
+ * @return Batch with one close price series per input series
+ */
+template<typename T>
+SeriesBatch<T> batchClosePrices(const std::vector<const std::vector<requests::OHLC>*>& series);
+
+/**
+ *  Computes the log returns of every series of a batch in parallel
+ * @param prices Batch of price series
+ * @return Batch where each series is one element shorter (empty for series shorter than 2)
+ */
+template<typename T>
+SeriesBatch<T> batchLogReturns(const SeriesBatch<T>& prices);
+}
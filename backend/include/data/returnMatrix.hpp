@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Log return series of many tokens aligned on a common time grid.
+ *  Every row is centered and scaled to unit norm over its observed samples,
+ *  missing samples are 0, so the dot product of two fully observed rows is
+ *  their Pearson correlation.
+ */
+struct ReturnMatrix
+{
+	std::vector<std::size_t> times;  /**< Common time grid, sorted */
+	std::vector<float> values;       /**< Row-major nbOfSeries x times.size() standardized returns */
+	std::vector<std::size_t> counts; /**< Number of observed samples of every row, 0 for constant series */
+
+	/**
+	 *  Gets the number of series (rows)
+	 */
+	std::size_t nbOfSeries() const { return counts.size(); }
+
+	/**
+	 *  Gets the number of time samples (columns)
+	 */
+	std::size_t nbOfSamples() const { return times.size(); }
+
+	/**
+	 *  Gets one standardized series
+	 */
+	std::span<const float> row(std::size_t i) const
+	{
+		return {values.data() + i * times.size(), times.size()};
+	}
+};
+
+/**
+ *  Aligns and standardizes log return series
+ * @param returns Log return series sorted by time, one per token
+ * @return Matrix with one row per series over the union of their timestamps
+ */
+ReturnMatrix buildReturnMatrix(const std::vector<std::vector<std::pair<std::size_t, float>>>& returns);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "requests/tokenPriceOHLCV.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace computations
+{
+/**
+ *  Per-token statistics of the mid-price log returns of a bar series
+ */
+struct RiskMetrics
+{
+	float volatility = 0;           /**< Sample standard deviation of log returns */
+	float downsideDeviation = 0;    /**< Root mean square of the negative log returns */
+	float maxDrawdown = 0;          /**< Largest peak-to-trough fall of the close, as a fraction */
+	float beta = 0;                 /**< Cov(returns, benchmark) / Var(benchmark) on common timestamps */
+	float skewness = 0;             /**< Bias-corrected sample skewness (G1) of log returns, 0 below 3 returns */
+	float kurtosis = 0;             /**< Bias-corrected sample excess kurtosis (G2) of log returns, 0 below 4 returns */
+	float volumeWeightedReturn = 0; /**< Log returns weighted by the volume of the bar they end at */
+	std::size_t nbOfReturns = 0;    /**< Number of log returns the metrics are based on */
+};
+
+/**
+ *  Computes all risk metrics of a bar series in a single pass
+ * @param bars Bars sorted by time
+ * @param benchmark Benchmark log returns sorted by time, used for beta
+ * @return Metrics of the series
+ */
+RiskMetrics computeRiskMetrics(
+		const std::vector<requests::OHLC>& bars,
+		const std::vector<std::pair<std::size_t, float>>& benchmark);
+
+/**
+ *  Computes the risk metrics of many bar series in parallel
+ * @param series Bar series, one per token
+ * @param benchmark Benchmark log returns sorted by time, used for beta
+ * @return Metrics of every series, in input order
+ */
+std::vector<RiskMetrics> computeRiskMetrics(
+		const std::vector<const std::vector<requests::OHLC>*>& series,
+		const std::vector<std::pair<std::size_t, float>>& benchmark);
+
+/**
+ *  Computes a weighted market log return for every timestamp present in any series
+ * @param returns Log return series, one per token, sorted by time
+ * @param weights Weight of every series (e.g. liquidity)
+ * @return Weighted average log return per timestamp, sorted by time
+ */
+std::vector<std::pair<std::size_t, float>> computeMarketLogReturns(
+		const std::vector<std::vector<std::pair<std::size_t, float>>>& returns,
+		const std::vector<float>& weights);
+}
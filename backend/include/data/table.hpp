@@ -20,8 +20,9 @@ class Table
 {
 	public:
 		/**
-		 *  Constructs a table from a file
-		 * @param filePath Path to the input file (CSV or JSON)
+		 *  Constructs a table from a file. CSV and JSON-lines files are
+		 *  split into chunks at line boundaries and parsed on all cores.
+		 * @param filePath Path to the input file (CSV, JSON or JSON-lines)
 		 */
 		Table(const std::string& filePath);
 
@@ -36,7 +37,7 @@ class Table
 		 * @param columnName Name of the column
 		 * @return DataType enum value representing the column's data type
 		 */
-		DataType getColumnDataType(const std::string& columnName);
+		DataType getColumnDataType(const std::string& columnName) const;
 
 		/**
 		 *  Gets string values from a column
@@ -87,6 +88,12 @@ class Table
 		 */
 		void initFromJson(const std::string& fileName);
 
+		/**
+		 *  Initializes table from a JSON-lines file, one object per line
+		 * @param fileName Path to the JSON-lines file
+		 */
+		void initFromJsonLines(const std::string& fileName);
+
 		/**
 		 *  Initializes table from a CSV file
 		 * @param fileName Path to the CSV file
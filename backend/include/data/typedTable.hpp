@@ -0,0 +1,463 @@
+#pragma once
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace table {
+
+/**
+ *  String literal usable as a template argument
+ */
+template <std::size_t N>
+struct FixedString
+{
+	constexpr FixedString(const char (&text)[N])
+	{
+		std::copy_n(text, N, value);
+	}
+
+	constexpr std::string_view view() const { return {value, N - 1}; }
+
+	char value[N]{};
+};
+
+/**
+ *  Column of a schema, its values are stored as T
+ */
+template <FixedString Name, typename T>
+struct Column
+{
+	static_assert(std::is_arithmetic_v<T> || std::is_same_v<T, std::string>,
+			"Columns hold arithmetic values or strings");
+
+	static constexpr std::string_view name = Name.view();
+	using type = T;
+};
+
+/**
+ *  Ordered list of the columns of a typed table
+ */
+template <typename... Columns>
+struct Schema
+{
+	static constexpr std::size_t size = sizeof...(Columns);
+	static constexpr std::array<std::string_view, size> names{Columns::name...};
+
+	/**
+	 *  Gets the index of a column, size when the schema has no such column
+	 */
+	static constexpr std::size_t indexOf(std::string_view name)
+	{
+		for (std::size_t i = 0; i < size; i++)
+			if (names[i] == name)
+				return i;
+		return size;
+	}
+};
+
+namespace detail {
+
+inline std::string readWholeFile(const std::string& filePath, std::ios::openmode mode = {})
+{
+	std::ifstream file(filePath, mode);
+	if (!file.is_open())
+		throw std::runtime_error("Unable to read file with the table");
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+inline void splitFields(std::string_view line, std::vector<std::string_view>& fields)
+{
+	fields.clear();
+	std::size_t begin = 0;
+	while (true)
+	{
+		const std::size_t end = line.find(',', begin);
+		fields.push_back(line.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin));
+		if (end == std::string_view::npos)
+			return;
+		begin = end + 1;
+	}
+}
+
+template <typename T>
+T parseCell(std::string_view text, std::size_t lineNumber)
+{
+	if constexpr (std::is_same_v<T, std::string>)
+	{
+		return std::string(text);
+	}else
+	{
+		T value{};
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc() || end != text.data() + text.size())
+			throw std::runtime_error("Invalid value '" + std::string(text) + "' on line " + std::to_string(lineNumber));
+		return value;
+	}
+}
+
+// Type tag of a column in the binary format: kind and size of the stored value
+template <typename T>
+constexpr std::uint16_t binaryTag()
+{
+	if constexpr (std::is_same_v<T, std::string>)
+		return 's' << 8;
+	else if constexpr (std::is_floating_point_v<T>)
+		return ('f' << 8) | sizeof(T);
+	else if constexpr (std::is_signed_v<T>)
+		return ('i' << 8) | sizeof(T);
+	else
+		return ('u' << 8) | sizeof(T);
+}
+
+template <typename T>
+void writeValue(std::string& out, const T& value)
+{
+	out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readValue(std::string_view& in)
+{
+	if (in.size() < sizeof(T))
+		throw std::runtime_error("Truncated binary table");
+	T value;
+	std::copy_n(in.data(), sizeof(T), reinterpret_cast<char*>(&value));
+	in.remove_prefix(sizeof(T));
+	return value;
+}
+
+constexpr std::uint32_t BINARY_MAGIC = 0x4C425454;  // "TTBL"
+constexpr std::uint32_t BINARY_VERSION = 1;
+}
+
+template <typename S>
+class TypedTable;
+
+/**
+ *  Table whose columns and their types are fixed at compile time. Columns
+ *  are stored as a tuple of vectors and addressed by name through a
+ *  constexpr index, so an access costs no hashing or type dispatch.
+ *  Use the dynamic Table for ad-hoc files.
+ */
+template <typename... Columns>
+class TypedTable<Schema<Columns...>>
+{
+	public:
+		using TableSchema = Schema<Columns...>;
+
+		/**
+		 *  Index of a column, fails to compile for unknown names
+		 */
+		template <FixedString Name>
+		static constexpr std::size_t columnIndex()
+		{
+			constexpr std::size_t index = TableSchema::indexOf(Name.view());
+			static_assert(index < TableSchema::size, "Schema has no such column");
+			return index;
+		}
+
+		template <FixedString Name>
+		using ValueType = std::tuple_element_t<columnIndex<Name>(), std::tuple<typename Columns::type...>>;
+
+		TypedTable() = default;
+
+		/**
+		 *  Loads a table from a file, the format is picked by extension
+		 * @param filePath Path to a .csv, .json or .bin file
+		 */
+		static TypedTable load(const std::string& filePath)
+		{
+			const std::string extension = filePath.substr(filePath.find_last_of('.') + 1);
+			if (extension == "csv" || extension == "CSV")
+				return fromCsv(filePath);
+			if (extension == "json" || extension == "JSON")
+				return fromJson(filePath);
+			if (extension == "bin" || extension == "BIN")
+				return fromBinary(filePath);
+			throw std::invalid_argument("Unsupported table format: " + filePath);
+		}
+
+		/**
+		 *  Loads a table from a CSV file with a header line. Columns are
+		 *  matched by name, extra columns of the file are ignored.
+		 * @param filePath Path to the CSV file
+		 */
+		static TypedTable fromCsv(const std::string& filePath)
+		{
+			const std::string content = detail::readWholeFile(filePath);
+			std::string_view rest = content;
+			std::vector<std::string_view> fields;
+			std::size_t lineNumber = 0;
+			auto nextLine = [&](std::string_view& line) {
+				if (rest.empty())
+					return false;
+				const std::size_t end = rest.find('\n');
+				line = rest.substr(0, end);
+				rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+				if (!line.empty() && line.back() == '\r')
+					line.remove_suffix(1);
+				lineNumber++;
+				return true;
+			};
+
+			std::string_view line;
+			if (!nextLine(line))
+				throw std::runtime_error("Table file has no header");
+			detail::splitFields(line, fields);
+			std::array<std::size_t, TableSchema::size> positions;
+			for (std::size_t c = 0; c < TableSchema::size; c++)
+			{
+				const auto it = std::find(fields.begin(), fields.end(), TableSchema::names[c]);
+				if (it == fields.end())
+					throw std::runtime_error("Column " + std::string(TableSchema::names[c]) + " is missing");
+				positions[c] = it - fields.begin();
+			}
+			const std::size_t nbOfFields = *std::max_element(positions.begin(), positions.end()) + 1;
+
+			TypedTable result;
+			result.reserve(std::count(rest.begin(), rest.end(), '\n') + 1);
+			while (nextLine(line))
+			{
+				if (line.empty())
+					continue;
+				detail::splitFields(line, fields);
+				if (fields.size() < nbOfFields)
+					throw std::runtime_error("Missing values on line " + std::to_string(lineNumber));
+				result.appendParsed(fields, positions, lineNumber, std::index_sequence_for<Columns...>{});
+			}
+			return result;
+		}
+
+		/**
+		 *  Loads a table from a JSON array of objects keyed by column name
+		 * @param filePath Path to the JSON file
+		 */
+		static TypedTable fromJson(const std::string& filePath)
+		{
+			std::ifstream file(filePath);
+			if (!file.is_open())
+				throw std::runtime_error("Unable to read file with the table");
+			return fromJson(nlohmann::json::parse(file));
+		}
+
+		/**
+		 *  Builds a table from a JSON array of objects keyed by column name,
+		 *  e.g. an API response
+		 * @param data JSON array
+		 */
+		static TypedTable fromJson(const nlohmann::json& data)
+		{
+			if (!data.is_array())
+				throw std::runtime_error("Table JSON must be an array of rows");
+			TypedTable result;
+			result.reserve(data.size());
+			for (const auto& item : data)
+				result.pushRow(item.at(std::string(Columns::name)).template get<typename Columns::type>()...);
+			return result;
+		}
+
+		/**
+		 *  Loads a table written by writeBinary, the column names and types must match the schema
+		 * @param filePath Path to the binary file
+		 */
+		static TypedTable fromBinary(const std::string& filePath)
+		{
+			const std::string content = detail::readWholeFile(filePath, std::ios::binary);
+			std::string_view in = content;
+			if (detail::readValue<std::uint32_t>(in) != detail::BINARY_MAGIC
+			 || detail::readValue<std::uint32_t>(in) != detail::BINARY_VERSION)
+				throw std::runtime_error("Not a binary table: " + filePath);
+			if (detail::readValue<std::uint64_t>(in) != TableSchema::size)
+				throw std::runtime_error("Binary table does not match the schema");
+
+			const std::array<std::uint16_t, TableSchema::size> tags{detail::binaryTag<typename Columns::type>()...};
+			for (std::size_t c = 0; c < TableSchema::size; c++)
+			{
+				const auto length = detail::readValue<std::uint64_t>(in);
+				if (length > in.size() || in.substr(0, length) != TableSchema::names[c])
+					throw std::runtime_error("Binary table does not match the schema");
+				in.remove_prefix(length);
+				if (detail::readValue<std::uint16_t>(in) != tags[c])
+					throw std::runtime_error("Binary table column " + std::string(TableSchema::names[c]) + " has another type");
+			}
+
+			const auto nbOfRows = detail::readValue<std::uint64_t>(in);
+			TypedTable result;
+			std::apply([&](auto&... columns) { (readColumn(in, columns, nbOfRows), ...); }, result.m_columns);
+			return result;
+		}
+
+		/**
+		 *  Writes the table in a native-endian binary format that loads without parsing
+		 * @param filePath Path of the output file
+		 */
+		void writeBinary(const std::string& filePath) const
+		{
+			std::string out;
+			detail::writeValue(out, detail::BINARY_MAGIC);
+			detail::writeValue(out, detail::BINARY_VERSION);
+			detail::writeValue<std::uint64_t>(out, TableSchema::size);
+			((detail::writeValue<std::uint64_t>(out, Columns::name.size()),
+			  out.append(Columns::name),
+			  detail::writeValue(out, detail::binaryTag<typename Columns::type>())), ...);
+			detail::writeValue<std::uint64_t>(out, size());
+			std::apply([&](const auto&... columns) { (writeColumn(out, columns), ...); }, m_columns);
+
+			std::ofstream file(filePath, std::ios::binary);
+			if (!file.is_open())
+				throw std::runtime_error("Unable to write the table to " + filePath);
+			file.write(out.data(), out.size());
+		}
+
+		/**
+		 *  Gets the number of rows
+		 */
+		std::size_t size() const { return std::get<0>(m_columns).size(); }
+
+		void reserve(std::size_t nbOfRows)
+		{
+			std::apply([&](auto&... columns) { (columns.reserve(nbOfRows), ...); }, m_columns);
+		}
+
+		/**
+		 *  Appends one row, values are given in schema order
+		 */
+		void pushRow(typename Columns::type... values)
+		{
+			pushRowImpl(std::index_sequence_for<Columns...>{}, std::move(values)...);
+		}
+
+		/**
+		 *  Gets all values of a column
+		 */
+		template <FixedString Name>
+		const std::vector<ValueType<Name>>& column() const
+		{
+			return std::get<columnIndex<Name>()>(m_columns);
+		}
+
+		template <FixedString Name>
+		std::vector<ValueType<Name>>& column()
+		{
+			return std::get<columnIndex<Name>()>(m_columns);
+		}
+
+		/**
+		 *  Gets a single value of a column
+		 */
+		template <FixedString Name>
+		const ValueType<Name>& at(std::size_t row) const
+		{
+			return column<Name>()[row];
+		}
+
+	private:
+		template <std::size_t... I>
+		void pushRowImpl(std::index_sequence<I...>, typename Columns::type&&... values)
+		{
+			(std::get<I>(m_columns).push_back(std::move(values)), ...);
+		}
+
+		template <std::size_t... I>
+		void appendParsed(
+				const std::vector<std::string_view>& fields,
+				const std::array<std::size_t, TableSchema::size>& positions,
+				std::size_t lineNumber,
+				std::index_sequence<I...>)
+		{
+			(std::get<I>(m_columns).push_back(
+				detail::parseCell<typename Columns::type>(fields[positions[I]], lineNumber)), ...);
+		}
+
+		template <typename T>
+		static void writeColumn(std::string& out, const std::vector<T>& values)
+		{
+			if constexpr (std::is_same_v<T, std::string>)
+			{
+				for (const auto& value : values)
+				{
+					detail::writeValue<std::uint64_t>(out, value.size());
+					out.append(value);
+				}
+			}else
+			{
+				out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+			}
+		}
+
+		template <typename T>
+		static void readColumn(std::string_view& in, std::vector<T>& values, std::size_t nbOfRows)
+		{
+			if constexpr (std::is_same_v<T, std::string>)
+			{
+				values.reserve(nbOfRows);
+				for (std::size_t i = 0; i < nbOfRows; i++)
+				{
+					const auto length = detail::readValue<std::uint64_t>(in);
+					if (length > in.size())
+						throw std::runtime_error("Truncated binary table");
+					values.emplace_back(in.substr(0, length));
+					in.remove_prefix(length);
+				}
+			}else
+			{
+				if (in.size() / sizeof(T) < nbOfRows)
+					throw std::runtime_error("Truncated binary table");
+				values.resize(nbOfRows);
+				std::copy_n(in.data(), nbOfRows * sizeof(T), reinterpret_cast<char*>(values.data()));
+				in.remove_prefix(nbOfRows * sizeof(T));
+			}
+		}
+
+		std::tuple<std::vector<typename Columns::type>...> m_columns;
+};
+
+/**
+ *  Schemas of the datasets read on hot paths
+ */
+namespace schemas {
+
+/** data/TokenOHLC.csv */
+using TokenOHLCCsv = Schema<
+	Column<"Time", std::int64_t>,
+	Column<"Open", float>,
+	Column<"High", float>,
+	Column<"Low", float>,
+	Column<"Close", float>>;
+
+/** Bars of the token OHLCV API */
+using OHLCV = Schema<
+	Column<"time", std::int64_t>,
+	Column<"volume", float>,
+	Column<"open", float>,
+	Column<"high", float>,
+	Column<"low", float>,
+	Column<"close", float>>;
+
+/** data/data.csv */
+using MarketData = Schema<
+	Column<"Date", std::string>,
+	Column<"SP500", float>,
+	Column<"Dividend", float>,
+	Column<"Earnings", float>,
+	Column<"Consumer Price Index", float>,
+	Column<"Long Interest Rate", float>,
+	Column<"Real Price", float>,
+	Column<"Real Dividend", float>,
+	Column<"Real Earnings", float>,
+	Column<"PE10", float>>;
+}
+}
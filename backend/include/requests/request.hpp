@@ -16,9 +16,16 @@ namespace requests {
  */
 class Request {
 public:
+    /**
+     * Base URL of the API when TAPTOOLS_API_URL is not set
+     */
+    static constexpr const char* DEFAULT_BASE_URL = "https://openapi.taptools.io/api/v1/";
+
     /**
      * Constructs Request object with specified endpoint
-     * @param endpoint API endpoint URL
+     * @param endpoint API endpoint, relative to the base URL. The base URL
+     *        can be overridden with the TAPTOOLS_API_URL environment
+     *        variable, e.g. to run against a local mock server
      */
     Request(const std::string& endpoint);
 
@@ -27,6 +34,9 @@ public:
      */
     ~Request();
 
+    Request(const Request&) = delete;
+    Request& operator=(const Request&) = delete;
+
     /**
      * Performs GET request with JSON parameters
      * @param params JSON parameters to include in the request
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "requests/request.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <vector>
+
+namespace requests {
+
+/**
+ * Structure representing one holder of a token
+ */
+struct Holder {
+    std::string address; /**< Stake address of the holder */
+    float amount;        /**< Number of tokens held */
+};
+
+/**
+ * Class for retrieving the largest holders of a token
+ */
+class TokenHolders {
+public:
+    static constexpr int MAX_HOLDERS_PER_PAGE = 100;
+
+    /**
+     * Constructs TokenHolders object for a specific token
+     * @param unit Token unit identifier
+     * @param nbOfHolders Number of top holders to fetch, in pages of MAX_HOLDERS_PER_PAGE
+     */
+    TokenHolders(const std::string& unit, int nbOfHolders = 100);
+
+    /**
+     * Updates holder information from the data source
+     */
+    void update();
+
+    /**
+     * Gets the fetched holders, largest first
+     * @return Vector of holders
+     */
+    const std::vector<struct Holder>& getData() const;
+
+    /**
+     * Gets the addresses of the fetched holders
+     * @return Vector of stake addresses
+     */
+    std::vector<std::string> getAddresses() const;
+
+private:
+    Request m_request;
+    std::string m_unit;
+    int m_nbOfHolders;
+    std::vector<struct Holder> m_data;
+};
+}
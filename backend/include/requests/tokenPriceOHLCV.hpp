@@ -31,8 +31,9 @@ public:
     /**
      * Constructs TokenOHLC object for a specific token
      * @param unit Token unit identifier
+     * @param interval Bar interval requested from the data source (e.g. "4h", "12h", "1d")
      */
-    TokenOHLC(const std::string& unit);
+    TokenOHLC(const std::string& unit, const std::string& interval = "12h");
 
     /**
      * Updates OHLC data from the data source
@@ -51,9 +52,22 @@ public:
      */
     float getAverageLogReturn();
 
+    /**
+     * Gets the fetched bars sorted by time
+     * @return Vector of OHLC bars
+     */
+    const std::vector<struct OHLC>& getData() const;
+
+    /**
+     * Gets the bar interval the data was fetched at
+     * @return Interval string as passed to the data source
+     */
+    const std::string& getInterval() const;
+
 private:
     Request m_request;
     std::string m_unit;
+    std::string m_interval;
     std::vector<struct OHLC> m_data;
     std::vector<std::string> m_colNames = {"time", "volume", "open", "high", "low", "close"};
     // We may assume that time always in incrementing order
@@ -22,9 +22,11 @@ struct Token {
  */
 class TopLiquidityTokens {
 public:
+    static constexpr int MAX_TOKENS_PER_PAGE = 100;
+
     /**
      * Constructs TopLiquidityTokens object
-     * @param nbOfTokens Number of top tokens to track
+     * @param nbOfTokens Number of top tokens to track, fetched in pages of MAX_TOKENS_PER_PAGE
      */
     TopLiquidityTokens(int nbOfTokens);
 
@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <cstddef>
+#include <functional>
+#include <utility>
 
 namespace tools {
 
@@ -26,6 +29,26 @@ void parseString(
  */
 std::string readSingleLineFile(const std::string& filePath);
 
+/**
+ * Splits [0, size) into contiguous chunks, one or more per hardware thread
+ * @param size Number of elements to split
+ * @param minChunkSize Smallest chunk worth handing to a separate thread
+ * @return Vector of [begin, end) ranges in increasing order
+ */
+std::vector<std::pair<std::size_t, std::size_t>> splitIntoChunks(
+    std::size_t size,
+    std::size_t minChunkSize);
+
+/**
+ * Runs task(i) for every i in [0, nbOfTasks) on a pool of hardware threads
+ * @param nbOfTasks Number of independent tasks
+ * @param task Callable receiving the task index
+ * @throws The first exception thrown by any task, after all threads joined
+ */
+void parallelForEach(
+    std::size_t nbOfTasks,
+    const std::function<void(std::size_t)>& task);
+
 } // namespace tools
 
 #endif // TOOLS_HPP
@@ -0,0 +1,286 @@
+#include "data/clustering.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace computations
+{
+namespace
+{
+void checkMatrix(const std::vector<float>& correlations, std::size_t n)
+{
+	if (correlations.size() != n * n)
+		throw std::invalid_argument("Correlation matrix must be N x N");
+}
+
+// Relabels ids in order of first appearance so outputs do not depend on internal numbering
+std::vector<int> compactLabels(const std::vector<std::size_t>& labels)
+{
+	std::unordered_map<std::size_t, int> ids;
+	std::vector<int> result(labels.size());
+	for (std::size_t i = 0; i < labels.size(); i++)
+		result[i] = ids.try_emplace(labels[i], static_cast<int>(ids.size())).first->second;
+	return result;
+}
+
+std::size_t findRoot(std::vector<std::size_t>& parents, std::size_t i)
+{
+	while (parents[i] != i)
+	{
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
+
+using Adjacency = std::vector<std::vector<std::pair<std::size_t, double>>>;
+
+/**
+ *  Moves nodes between communities while modularity improves
+ * @return True when at least one node changed community
+ */
+bool moveNodes(const Adjacency& graph, std::vector<std::size_t>& community)
+{
+	const std::size_t n = graph.size();
+	std::vector<double> degrees(n, 0.0);
+	double totalWeight = 0.0;
+	for (std::size_t i = 0; i < n; i++)
+	{
+		for (const auto& [j, w] : graph[i])
+			degrees[i] += w;
+		totalWeight += degrees[i];
+	}
+	if (totalWeight <= 0.0)
+		return false;
+
+	std::vector<double> communityDegrees(n, 0.0);
+	for (std::size_t i = 0; i < n; i++)
+		communityDegrees[community[i]] += degrees[i];
+
+	std::vector<double> linkWeights(n, 0.0);
+	std::vector<std::size_t> touched;
+	bool movedAny = false;
+	for (bool moved = true; moved;)
+	{
+		moved = false;
+		for (std::size_t i = 0; i < n; i++)
+		{
+			const std::size_t current = community[i];
+			touched.clear();
+			touched.push_back(current);
+			for (const auto& [j, w] : graph[i])
+			{
+				if (j == i)
+					continue;
+				if (linkWeights[community[j]] == 0.0)
+					touched.push_back(community[j]);
+				linkWeights[community[j]] += w;
+			}
+
+			communityDegrees[current] -= degrees[i];
+			std::size_t best = current;
+			double bestGain = linkWeights[current] - communityDegrees[current] * degrees[i] / totalWeight;
+			for (auto c : touched)
+			{
+				const double gain = linkWeights[c] - communityDegrees[c] * degrees[i] / totalWeight;
+				if (gain > bestGain + 1e-12)
+				{
+					bestGain = gain;
+					best = c;
+				}
+			}
+			communityDegrees[best] += degrees[i];
+			community[i] = best;
+
+			for (auto c : touched)
+				linkWeights[c] = 0.0;
+			if (best != current)
+			{
+				moved = true;
+				movedAny = true;
+			}
+		}
+	}
+	return movedAny;
+}
+}
+
+float correlationDistance(float correlation)
+{
+	return std::sqrt(std::max(0.0f, 2.0f * (1.0f - correlation)));
+}
+
+std::vector<TreeEdge> computeMinimumSpanningTree(const std::vector<float>& correlations, std::size_t n)
+{
+	checkMatrix(correlations, n);
+	std::vector<TreeEdge> tree;
+	if (n < 2)
+		return tree;
+	tree.reserve(n - 1);
+
+	std::vector<bool> inTree(n, false);
+	std::vector<float> distances(n, std::numeric_limits<float>::infinity());
+	std::vector<std::size_t> parents(n, 0);
+	std::size_t next = 0;
+	for (std::size_t step = 0; step < n; step++)
+	{
+		const std::size_t u = next;
+		inTree[u] = true;
+		if (step > 0)
+			tree.push_back({.a = parents[u], .b = u, .distance = distances[u]});
+
+		float best = std::numeric_limits<float>::infinity();
+		const float* row = correlations.data() + u * n;
+		for (std::size_t v = 0; v < n; v++)
+		{
+			if (inTree[v])
+				continue;
+			const float d = correlationDistance(row[v]);
+			if (d < distances[v])
+			{
+				distances[v] = d;
+				parents[v] = u;
+			}
+			if (distances[v] < best)
+			{
+				best = distances[v];
+				next = v;
+			}
+		}
+	}
+	return tree;
+}
+
+std::vector<int> computeHierarchicalClusters(
+		const std::vector<float>& correlations,
+		std::size_t n,
+		float maxDistance)
+{
+	checkMatrix(correlations, n);
+
+	// Cluster distances live in the slot of one of their members, merged slots are deactivated
+	std::vector<float> distances(n * n);
+	for (std::size_t i = 0; i < n * n; i++)
+		distances[i] = correlationDistance(correlations[i]);
+	std::vector<std::size_t> sizes(n, 1);
+	std::vector<bool> active(n, true);
+	std::vector<std::size_t> parents(n);
+	std::iota(parents.begin(), parents.end(), 0);
+
+	std::vector<std::size_t> chain;
+	std::size_t nbOfActive = n;
+	std::size_t nextStart = 0;
+	while (nbOfActive > 1)
+	{
+		if (chain.empty())
+		{
+			while (!active[nextStart])
+				nextStart++;
+			chain.push_back(nextStart);
+		}
+
+		const std::size_t a = chain.back();
+		const std::size_t previous = chain.size() > 1 ? chain[chain.size() - 2] : n;
+		// Ties prefer the previous chain element, which guarantees the chain ends in a reciprocal pair
+		std::size_t b = previous;
+		float best = previous < n ? distances[a * n + previous] : std::numeric_limits<float>::infinity();
+		for (std::size_t k = 0; k < n; k++)
+		{
+			if (!active[k] || k == a)
+				continue;
+			if (distances[a * n + k] < best)
+			{
+				best = distances[a * n + k];
+				b = k;
+			}
+		}
+
+		if (b != previous)
+		{
+			chain.push_back(b);
+			continue;
+		}
+
+		// a and b are reciprocal nearest neighbours, merge b into a
+		chain.pop_back();
+		chain.pop_back();
+		if (best <= maxDistance)
+			parents[findRoot(parents, b)] = findRoot(parents, a);
+
+		const float weightA = static_cast<float>(sizes[a]);
+		const float weightB = static_cast<float>(sizes[b]);
+		for (std::size_t k = 0; k < n; k++)
+		{
+			if (!active[k] || k == a || k == b)
+				continue;
+			const float d = (weightA * distances[a * n + k] + weightB * distances[b * n + k]) / (weightA + weightB);
+			distances[a * n + k] = d;
+			distances[k * n + a] = d;
+		}
+		sizes[a] += sizes[b];
+		active[b] = false;
+		nbOfActive--;
+	}
+
+	std::vector<std::size_t> roots(n);
+	for (std::size_t i = 0; i < n; i++)
+		roots[i] = findRoot(parents, i);
+	return compactLabels(roots);
+}
+
+std::vector<int> computeLouvainCommunities(std::size_t n, const std::vector<WeightedEdge>& edges)
+{
+	Adjacency graph(n);
+	for (const auto& edge : edges)
+	{
+		if (edge.a >= n || edge.b >= n)
+			throw std::out_of_range("Edge refers to an unknown node");
+		if (!(edge.weight > 0) || edge.a == edge.b)
+			continue;
+		graph[edge.a].emplace_back(edge.b, edge.weight);
+		graph[edge.b].emplace_back(edge.a, edge.weight);
+	}
+
+	// membership maps every original node to its node in the current aggregated graph
+	std::vector<std::size_t> membership(n);
+	std::iota(membership.begin(), membership.end(), 0);
+	while (true)
+	{
+		std::vector<std::size_t> community(graph.size());
+		std::iota(community.begin(), community.end(), 0);
+		if (!moveNodes(graph, community))
+			break;
+
+		std::vector<std::size_t> renumber(graph.size(), graph.size());
+		std::size_t nbOfCommunities = 0;
+		for (auto& c : community)
+		{
+			if (renumber[c] == graph.size())
+				renumber[c] = nbOfCommunities++;
+			c = renumber[c];
+		}
+		for (auto& m : membership)
+			m = community[m];
+
+		// Each community becomes a node, internal weight turns into a self loop
+		std::vector<std::unordered_map<std::size_t, double>> merged(nbOfCommunities);
+		for (std::size_t i = 0; i < graph.size(); i++)
+			for (const auto& [j, w] : graph[i])
+				merged[community[i]][community[j]] += w;
+
+		Adjacency aggregated(nbOfCommunities);
+		for (std::size_t c = 0; c < nbOfCommunities; c++)
+		{
+			aggregated[c].assign(merged[c].begin(), merged[c].end());
+			std::sort(aggregated[c].begin(), aggregated[c].end());
+		}
+		graph = std::move(aggregated);
+	}
+	return compactLabels(membership);
+}
+}
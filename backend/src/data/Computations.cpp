@@ -1,11 +1,25 @@
 #include "data/computations.hpp"
 #include "requests/topLiquidityTokens.hpp"
 #include "requests/tokenPriceOHLCV.hpp"
+#include "requests/tokenHolders.hpp"
+#include "data/ohlcPyramid.hpp"
+#include "data/returnKernels.hpp"
+#include "data/riskMetrics.hpp"
+#include "data/returnMatrix.hpp"
+#include "data/leadLag.hpp"
+#include "data/correlationSearch.hpp"
+#include "data/forceLayout.hpp"
+#include "data/clustering.hpp"
+#include "data/factorModel.hpp"
+#include "data/minHash.hpp"
 
 #include <cmath>
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
 
 using namespace table;
 using namespace requests;
@@ -14,19 +28,41 @@ namespace computations
 std::vector<float> computeLogReturns(const Table& t, const std::string& columnName)
 {
 	const std::vector<float>& values =  t.getFloatColumnValues(columnName);
-	std::vector<float> resualt;
-	for(auto i = 0; i<values.size()-1; i++)
-	{
-		resualt.push_back(std::log(values[i+1]/values[i]));
-	}
+	std::vector<float> resualt(values.size() < 2 ? 0 : values.size() - 1);
+	computeLogReturns<float>(values, resualt);
 	return resualt;
 }
 
+/**
+ *  Pairs each log return with the timestamp of the bar it ends at
+ * @param bars Bars the returns were computed from
+ * @param logReturns Log returns of the bars
+ * @return Vector of pairs containing bar timestamp and log return
+ */
+std::vector<std::pair<std::size_t, float>> timestampLogReturns(
+		const std::vector<OHLC>& bars,
+		std::span<const float> logReturns)
+{
+	std::vector<std::pair<std::size_t, float>> result;
+	result.reserve(logReturns.size());
+	for (std::size_t i = 0; i < logReturns.size(); i++)
+		result.emplace_back(bars[i+1].time, logReturns[i]);
+	return result;
+}
+
+std::vector<std::pair<std::size_t, float>> computeMidPriceLogReturns(const std::vector<OHLC>& bars)
+{
+	const SeriesBatch<float> logReturns = batchLogReturns(batchMidPrices<float>({&bars}));
+	return timestampLogReturns(bars, logReturns[0]);
+}
+
 struct LogReturnsGraphNode
 {
 	std::string unit;
 	std::string ticker;
-	TokenOHLC   data;
+	float price;
+	float liquidity;
+	OHLCPyramid data;
 };
 
 struct LogReturnsGraphEdge
@@ -36,105 +72,380 @@ struct LogReturnsGraphEdge
 	float avarageCorilation;
 };
 
-void generateLogReturnsGraph(std::string filePath){
-	TopLiquidityTokens tokens(100);
-	std::vector<LogReturnsGraphNode> nodes;
+/**
+ *  Pearson correlation of two log return series over their common tail
+ * @param avgLROTA First series sorted by time
+ * @param avgLROTB Second series sorted by time
+ * @param n Set to the number of measurements used
+ * @return Correlation, 0 when it is undefined
+ */
+float computeCorrelation(
+		const std::vector<std::pair<std::size_t, float>>& avgLROTA,
+		const std::vector<std::pair<std::size_t, float>>& avgLROTB,
+		std::size_t& n)
+{
+	std::size_t startA = 0;
+	std::size_t startB = 0;
+	n = 0;
 
-	std::vector<std::string> tokensUnits = tokens.getVectorOfUnits();
+	if (avgLROTA.empty() || avgLROTB.empty())
+		return 0.0;
+
+	if (avgLROTA.size() > avgLROTB.size()){
+		while (startA < avgLROTA.size() && avgLROTA[startA].first < avgLROTB[0].first){
+			startA++;
+		}
+	}else{
+		while (startB < avgLROTB.size() && avgLROTB[startB].first < avgLROTA[0].first){
+			startB++;
+		}
+	}
+	float sumX = 0.0, sumY = 0.0, sumXY = 0.0, sumX2 = 0.0, sumY2 = 0.0;
+	while (startB < avgLROTB.size() && startA < avgLROTA.size()){
+		sumX += avgLROTA[startA].second;
+		sumY += avgLROTB[startB].second;
+		sumXY += avgLROTA[startA].second * avgLROTB[startB].second;
+		sumX2 += avgLROTA[startA].second * avgLROTA[startA].second;
+		sumY2 += avgLROTB[startB].second * avgLROTB[startB].second;
+
+		startB++;
+		startA++;
+		n++;
+	}
+	float numerator = n * sumXY - sumX * sumY;
+	float denominator = std::sqrt((n * sumX2 - sumX * sumX) * (n * sumY2 - sumY * sumY));
+
+	if (denominator == 0.0 || std::isnan(denominator)) {
+		return 0.0; // Handle division by zero
+	}
+
+	return numerator / denominator;
+}
+
+/**
+ *  Builds the graph of one horizon from the nodes' shared price data
+ * @param nodes Graph nodes, their pyramids get the requested level added
+ * @param intervalSeconds Bar interval of the graph
+ * @param options Generation options
+ * @param previousPositions Layout positions of the previous run by token unit
+ * @return Graph with "nodes" and "links" arrays
+ */
+nlohmann::json buildLogReturnsGraph(
+		std::vector<LogReturnsGraphNode>& nodes,
+		std::size_t intervalSeconds,
+		const GraphOptions& options,
+		const std::unordered_map<std::string, Position>& previousPositions)
+{
+	// Log returns of all tokens are computed in one batch
+	std::vector<const std::vector<OHLC>*> levels;
+	levels.reserve(nodes.size());
+	for (auto& node : nodes)
+		levels.push_back(&node.data.getLevel(intervalSeconds));
+	const SeriesBatch<float> logReturns = batchLogReturns(batchMidPrices<float>(levels));
+
+	std::vector<std::vector<std::pair<std::size_t, float>>> returns;
+	std::vector<float> liquidities;
+	returns.reserve(nodes.size());
+	liquidities.reserve(nodes.size());
+	for (std::size_t i = 0; i < nodes.size(); i++){
+		returns.push_back(timestampLogReturns(*levels[i], logReturns[i]));
+		liquidities.push_back(nodes[i].liquidity);
+	}
+
+	// Beta is measured against the liquidity weighted market of the graph's tokens
+	const auto market = computeMarketLogReturns(returns, liquidities);
+	const std::vector<RiskMetrics> metrics = computeRiskMetrics(levels, market);
 
 	nlohmann::json nodesJ = nlohmann::json::array();
-	for (auto unit : tokensUnits){
+	for (std::size_t i = 0; i < nodes.size(); i++){
+		const auto& node = nodes[i];
+
+		float sumLogReturns = 0.0f;
+		for (const auto& [time, logReturn] : returns[i])
+			sumLogReturns += logReturn;
 
-		TokenOHLC data{unit};
-		nodes.push_back(
-			LogReturnsGraphNode{
-				.unit = unit,
-				.ticker = tokens.getTicker(unit),
-				.data = data
-			}
-		);
 		nlohmann::json token;
-		token["id"] = unit;
-		token["name"] = tokens.getTicker(unit);
-		token["price"] = tokens.getPrice(unit);
-		token["liquidity"] = tokens.getLiquidity(unit);
-		token["avgLogReturn"] = data.getAverageLogReturn();
+		token["id"] = node.unit;
+		token["name"] = node.ticker;
+		token["price"] = node.price;
+		token["liquidity"] = node.liquidity;
+		token["avgLogReturn"] = returns[i].empty() ? 0.0f : sumLogReturns / returns[i].size();
+		token["volatility"] = metrics[i].volatility;
+		token["downsideDeviation"] = metrics[i].downsideDeviation;
+		token["maxDrawdown"] = metrics[i].maxDrawdown;
+		token["beta"] = metrics[i].beta;
+		token["skewness"] = metrics[i].skewness;
+		token["kurtosis"] = metrics[i].kurtosis;
+		token["volumeWeightedReturn"] = metrics[i].volumeWeightedReturn;
 		nodesJ.push_back(token);
 	}
-	
+
+	ReturnMatrix matrix;
+	if (options.approximate || options.leadLag || options.factorModel)
+		matrix = buildReturnMatrix(returns);
+
+	FactorModel factors;
+	if (options.factorModel){
+		factors = computeFactorModel(matrix, {.factors = options.nbOfFactors});
+		for (std::size_t i = 0; i < nodes.size(); i++){
+			const auto loadings = factors.getLoadings(i);
+			nodesJ[i]["loadings"] = std::vector<float>(loadings.begin(), loadings.end());
+			nodesJ[i]["idiosyncraticVariance"] = factors.getIdiosyncraticVariance(i);
+		}
+	}
+
+	// Pairs to correlate, every pair or only the approximate nearest neighbours
+	std::vector<std::pair<std::size_t, std::size_t>> pairs;
+	float annRecall = 1.0f;
+	if (options.approximate){
+		const NeighbourSearchResult search = findCorrelatedNeighbours(matrix, {
+			.neighbours = options.approximateNeighbours
+		});
+		annRecall = search.recall;
+		std::cout << "Approximate correlation search: " << search.nbOfCandidates
+			<< " candidates, recall " << annRecall << std::endl;
+		pairs.reserve(search.edges.size());
+		for (const auto& edge : search.edges)
+			pairs.emplace_back(edge.a, edge.b);
+	}else{
+		pairs.reserve(nodes.size() * nodes.size() / 2);
+		for (std::size_t i = 0; i + 1 < nodes.size(); i++)
+			for (auto j = i +1; j < nodes.size(); j++)
+				pairs.emplace_back(i, j);
+	}
+
 	nlohmann::json links = nlohmann::json::array();
 	std::vector<LogReturnsGraphEdge> edges;
-	for (auto i = 0; i < nodes.size() - 1; i++){
-		for (auto j = i +1; j < nodes.size(); j++){
-
-			auto nodeA = nodes[i];
-			auto nodeB = nodes[j];
-
-			if (nodeA.ticker == nodeB.ticker)
-				continue;
-
-			std::vector<std::pair<std::size_t, float>> avgLROTA = nodeA.data.getAvgLogReturnsOverTime();
-			std::vector<std::pair<std::size_t, float>> avgLROTB = nodeB.data.getAvgLogReturnsOverTime();
-
-			std::size_t startA = 0;
-			std::size_t startB = 0;
-			std::size_t n = 0;
-
-			if (avgLROTA.size() > avgLROTB.size()){
-				while (startA < avgLROTA.size() && avgLROTA[startA].first < avgLROTB[0].first){
-					startA++;
-				}
-			}else{
-				while (startB < avgLROTB.size() && avgLROTB[startB].first < avgLROTA[0].first){
-					startB++;
-				}
-			}
-			float sumX = 0.0, sumY = 0.0, sumXY = 0.0, sumX2 = 0.0, sumY2 = 0.0;
-			while (startB < avgLROTB.size() && startA < avgLROTA.size()){
-				sumX += avgLROTA[startA].second;
-				sumY += avgLROTB[startB].second;
-				sumXY += avgLROTA[startA].second * avgLROTB[startB].second;
-				sumX2 += avgLROTA[startA].second * avgLROTA[startA].second;
-				sumY2 += avgLROTB[startB].second * avgLROTB[startB].second;
-
-				startB++;	
-				startA++;
-				n++;
-			}
-			float numerator = n * sumXY - sumX * sumY;
-			float denominator = std::sqrt((n * sumX2 - sumX * sumX) * (n * sumY2 - sumY * sumY));
+	std::vector<LayoutEdge> layoutEdges;
+	std::vector<WeightedEdge> communityEdges;
+	// Dense matrix for the spanning tree and the hierarchical clustering, only when every pair is known
+	const bool dense = options.clustering && !options.approximate;
+	std::vector<float> correlations(dense ? nodes.size() * nodes.size() : 0, 0.0f);
+	if (dense){
+		for (std::size_t i = 0; i < nodes.size(); i++)
+			correlations[i * nodes.size() + i] = 1.0f;
+	}
+	for (const auto& [i, j] : pairs){
+
+		const auto& nodeA = nodes[i];
+		const auto& nodeB = nodes[j];
 
-			float avarageCorilation = 0;
-			if (denominator == 0.0) {
-				avarageCorilation = 0.0; // Handle division by zero
+		if (nodeA.ticker == nodeB.ticker)
+			continue;
+
+		std::size_t n = 0;
+		float avarageCorilation = computeCorrelation(returns[i], returns[j], n);
+
+		edges.push_back(
+			{
+				.tickerA = nodeA.ticker,
+				.tickerB = nodeB.ticker,
+				.avarageCorilation = avarageCorilation
 			}
+		);
+		nlohmann::json link;
+		link["source"] = nodeA.unit;
+		link["target"] = nodeB.unit;
+		link["avarageCorilation"] = avarageCorilation;
+		link["nbOfMesurments"] = n;
+		if (options.factorModel)
+			link["residualCorrelation"] = factors.residualCorrelation(i, j, avarageCorilation);
+		links.push_back(link);
 
-			avarageCorilation = numerator / denominator;
+		if (avarageCorilation > 0)
+			layoutEdges.push_back({.source = i, .target = j, .weight = avarageCorilation});
+		if (avarageCorilation >= options.communityThreshold)
+			communityEdges.push_back({.a = i, .b = j, .weight = avarageCorilation});
+		if (dense){
+			correlations[i * nodes.size() + j] = avarageCorilation;
+			correlations[j * nodes.size() + i] = avarageCorilation;
+		}
+	}
 
-			edges.push_back(
-				{
-					.tickerA = nodeA.ticker,
-					.tickerB = nodeB.ticker,
-					.avarageCorilation = avarageCorilation
-				}
-			);
+	if (options.layout){
+		std::vector<std::optional<Position>> previous(nodes.size());
+		for (std::size_t i = 0; i < nodes.size(); i++){
+			if (auto it = previousPositions.find(nodes[i].unit); it != previousPositions.end())
+				previous[i] = it->second;
+		}
+
+		const std::vector<Position> positions = computeForceLayout(nodes.size(), layoutEdges, previous);
+		for (std::size_t i = 0; i < nodes.size(); i++){
+			nodesJ[i]["x"] = positions[i].x;
+			nodesJ[i]["y"] = positions[i].y;
+			nodesJ[i]["z"] = positions[i].z;
+		}
+	}
+
+	nlohmann::json backbone = nlohmann::json::array();
+	if (options.clustering){
+		const std::vector<int> communities = computeLouvainCommunities(nodes.size(), communityEdges);
+		for (std::size_t i = 0; i < nodes.size(); i++)
+			nodesJ[i]["community"] = communities[i];
+	}
+	if (dense){
+		const std::vector<int> clusters = computeHierarchicalClusters(correlations, nodes.size(), options.clusterDistance);
+		for (std::size_t i = 0; i < nodes.size(); i++)
+			nodesJ[i]["cluster"] = clusters[i];
+
+		for (const auto& edge : computeMinimumSpanningTree(correlations, nodes.size())){
 			nlohmann::json link;
-			link["source"] = nodeA.unit;
-			link["target"] = nodeB.unit;
-			link["avarageCorilation"] = avarageCorilation;
-			link["nbOfMesurments"] = n;
-			links.push_back(link);
+			link["source"] = nodes[edge.a].unit;
+			link["target"] = nodes[edge.b].unit;
+			link["distance"] = edge.distance;
+			backbone.push_back(link);
 		}
 	}
 
 	nlohmann::json resultOutput;
 	resultOutput["nodes"] = nodesJ;
 	resultOutput["links"] = links;
-	
-	std::ofstream outputFile(filePath);
-	outputFile << resultOutput.dump(2);
-	outputFile.close();
+	if (options.approximate)
+		resultOutput["annRecall"] = annRecall;
+	if (dense)
+		resultOutput["backbone"] = backbone;
+	if (options.factorModel){
+		resultOutput["factors"]["eigenvalues"] = factors.getEigenvalues();
+		resultOutput["factors"]["explainedVariance"] = factors.getExplainedVariance();
+	}
+
+	if (options.leadLag){
+		nlohmann::json leadLagLinks = nlohmann::json::array();
+		// In approximate mode only the nearest-neighbour pairs are searched, all pairs would be quadratic
+		const std::vector<LeadLagEdge> leadLagEdges = options.approximate
+			? computeLeadLag(matrix, pairs, options.maxLag, options.leadLagThreshold, options.leadLagPValue)
+			: computeLeadLag(matrix, options.maxLag, options.leadLagThreshold, options.leadLagPValue);
+		for (const auto& edge : leadLagEdges){
+			nlohmann::json link;
+			link["source"] = nodes[edge.leader].unit;
+			link["target"] = nodes[edge.follower].unit;
+			link["lag"] = edge.lag;
+			link["leadLagCorrelation"] = edge.correlation;
+			leadLagLinks.push_back(link);
+		}
+		resultOutput["leadLagLinks"] = leadLagLinks;
+	}
+	return resultOutput;
+}
+
+/**
+ *  Reads the node positions of a previously written graph
+ * @param filePath Path of the graph file
+ * @return Positions by token unit, empty when the file is missing or has no layout
+ */
+std::unordered_map<std::string, Position> readLayoutPositions(const std::string& filePath)
+{
+	std::unordered_map<std::string, Position> positions;
+	std::ifstream inputFile(filePath);
+	if (!inputFile.is_open())
+		return positions;
+
+	const nlohmann::json graph = nlohmann::json::parse(inputFile, nullptr, false);
+	if (graph.is_discarded() || !graph.contains("nodes"))
+		return positions;
+
+	for (const auto& node : graph["nodes"]){
+		if (node.contains("id") && node.contains("x") && node.contains("y") && node.contains("z"))
+			positions[node["id"].get<std::string>()] = {node["x"], node["y"], node["z"]};
+	}
+	return positions;
+}
+
+/**
+ *  Links tokens whose top holders overlap, tokens whose holders cannot be fetched are left out
+ * @param units Units of the tokens
+ * @param options Number of holders and similarity threshold
+ * @return JSON array of links with the estimated Jaccard similarity
+ */
+nlohmann::json buildHolderLinks(const std::vector<std::string>& units, const GraphOptions& options)
+{
+	std::vector<std::vector<std::string>> holders;
+	holders.reserve(units.size());
+	for (const auto& unit : units){
+		// Holder links are optional, a token whose holders cannot be fetched just gets no links
+		try{
+			holders.push_back(TokenHolders(unit, options.nbOfHolders).getAddresses());
+		}catch (const std::exception& e){
+			std::cerr << "Skipping holders of " << unit << ": " << e.what() << std::endl;
+			holders.emplace_back();
+		}
+	}
+
+	nlohmann::json holderLinks = nlohmann::json::array();
+	for (const auto& edge : findSimilarSets(holders, {.minSimilarity = options.holderSimilarityThreshold})){
+		nlohmann::json link;
+		link["source"] = units[edge.a];
+		link["target"] = units[edge.b];
+		link["holderJaccard"] = edge.jaccard;
+		holderLinks.push_back(link);
+	}
+	return holderLinks;
+}
+
+std::string horizonFilePath(const std::string& filePath, const std::string& horizon)
+{
+	const auto dot = filePath.find_last_of('.');
+	const auto slash = filePath.find_last_of('/');
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+		return filePath + "_" + horizon;
+	return filePath.substr(0, dot) + "_" + horizon + filePath.substr(dot);
+}
+
+void generateLogReturnsGraph(std::string filePath, const GraphOptions& options){
+	if (options.horizons.empty())
+		throw std::invalid_argument("At least one horizon is required");
+
+	// Prices are fetched once at the finest horizon, the others are resampled from it
+	std::vector<std::size_t> intervals;
+	for (const auto& horizon : options.horizons)
+		intervals.push_back(intervalToSeconds(horizon));
+	const std::size_t base = std::min_element(intervals.begin(), intervals.end()) - intervals.begin();
+	for (std::size_t h = 0; h < intervals.size(); h++){
+		if (intervals[h] % intervals[base] != 0)
+			throw std::invalid_argument("Horizon " + options.horizons[h]
+					+ " is not a multiple of " + options.horizons[base]);
+	}
+
+	TopLiquidityTokens tokens(options.nbOfTokens);
+	std::vector<LogReturnsGraphNode> nodes;
+
+	std::vector<std::string> tokensUnits = tokens.getVectorOfUnits();
+	nodes.reserve(tokensUnits.size());
+
+	for (const auto& unit : tokensUnits){
+		TokenOHLC data{unit, options.horizons[base]};
+		nodes.push_back(
+			LogReturnsGraphNode{
+				.unit = unit,
+				.ticker = tokens.getTicker(unit),
+				.price = tokens.getPrice(unit),
+				.liquidity = tokens.getLiquidity(unit),
+				.data = OHLCPyramid(data.getData(), intervals[base])
+			}
+		);
+	}
+
+	// Holder overlap does not depend on the horizon, it is computed once for all graphs
+	nlohmann::json holderLinks;
+	if (options.holderSimilarity)
+		holderLinks = buildHolderLinks(tokensUnits, options);
+
+	for (std::size_t h = 0; h < intervals.size(); h++){
+		const std::string outputPath = h == 0 ? filePath : horizonFilePath(filePath, options.horizons[h]);
 
+		// The previous snapshot seeds the layout so positions stay stable between runs
+		std::unordered_map<std::string, Position> previousPositions;
+		if (options.layout)
+			previousPositions = readLayoutPositions(outputPath);
+
+		nlohmann::json resultOutput = buildLogReturnsGraph(nodes, intervals[h], options, previousPositions);
+		if (options.holderSimilarity)
+			resultOutput["holderLinks"] = holderLinks;
+
+		std::ofstream outputFile(outputPath);
+		outputFile << resultOutput.dump(2);
+		outputFile.close();
+	}
 }
 
 }
@@ -0,0 +1,384 @@
+#include "data/correlationSearch.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+
+namespace computations
+{
+namespace
+{
+struct Neighbour
+{
+	std::size_t row;
+	float correlation;
+};
+
+float dot(const float* a, const float* b, std::size_t size)
+{
+	float sum = 0.0f;
+	for (std::size_t i = 0; i < size; i++)
+		sum += a[i] * b[i];
+	return sum;
+}
+
+// Keeps the `count` entries of largest absolute correlation, strongest first
+void keepStrongest(std::vector<Neighbour>& neighbours, std::size_t count)
+{
+	auto stronger = [](const Neighbour& x, const Neighbour& y) {
+		return std::abs(x.correlation) > std::abs(y.correlation)
+			|| (std::abs(x.correlation) == std::abs(y.correlation) && x.row < y.row);
+	};
+	if (neighbours.size() > count)
+	{
+		std::nth_element(neighbours.begin(), neighbours.begin() + count, neighbours.end(), stronger);
+		neighbours.resize(count);
+	}
+	std::sort(neighbours.begin(), neighbours.end(), stronger);
+}
+
+/**
+ *  Hierarchical navigable small world graph (Malkov & Yashunin) over unit
+ *  vectors, with 1 - dot product as distance
+ */
+class HnswIndex
+{
+	public:
+		using Result = std::pair<float, std::uint32_t>;
+
+		/**
+		 *  Per-thread buffers of a search
+		 */
+		struct Scratch
+		{
+			std::vector<std::uint32_t> visited;
+			std::uint32_t stamp = 0;
+		};
+
+		HnswIndex(const std::vector<float>& vectors, std::size_t dimensions, std::size_t m, std::size_t efConstruction, std::uint64_t seed)
+			: m_vectors(vectors)
+			, m_dimensions(dimensions)
+			, m_m(m)
+			, m_efConstruction(efConstruction)
+			, m_levelScale(1.0 / std::log(static_cast<double>(m)))
+			, m_generator(seed)
+			, m_links(vectors.size() / dimensions)
+		{
+		}
+
+		void insert(std::uint32_t id, Scratch& scratch)
+		{
+			std::uniform_real_distribution<double> uniform(std::numeric_limits<double>::min(), 1.0);
+			const int level = static_cast<int>(-std::log(uniform(m_generator)) * m_levelScale);
+			m_links[id].resize(level + 1);
+
+			if (m_entryPoint < 0)
+			{
+				m_entryPoint = id;
+				m_maxLevel = level;
+				return;
+			}
+
+			const float* query = vector(id);
+			std::uint32_t entry = static_cast<std::uint32_t>(m_entryPoint);
+			for (int l = m_maxLevel; l > level; l--)
+				entry = greedyClosest(query, entry, l);
+
+			for (int l = std::min(level, m_maxLevel); l >= 0; l--)
+			{
+				std::vector<Result> candidates = searchLayer(query, entry, m_efConstruction, l, scratch);
+				entry = candidates.front().second;
+				const std::size_t maxLinks = l == 0 ? 2 * m_m : m_m;
+				m_links[id][l] = selectNeighbours(candidates, m_m);
+				for (auto neighbour : m_links[id][l])
+				{
+					auto& links = m_links[neighbour][l];
+					links.push_back(id);
+					if (links.size() > maxLinks)
+					{
+						std::vector<Result> pruned;
+						pruned.reserve(links.size());
+						for (auto link : links)
+							pruned.emplace_back(distance(vector(neighbour), link), link);
+						std::sort(pruned.begin(), pruned.end());
+						links = selectNeighbours(pruned, maxLinks);
+					}
+				}
+			}
+
+			if (level > m_maxLevel)
+			{
+				m_maxLevel = level;
+				m_entryPoint = id;
+			}
+		}
+
+		std::vector<Result> search(const float* query, std::size_t k, std::size_t ef, Scratch& scratch) const
+		{
+			if (m_entryPoint < 0)
+				return {};
+
+			std::uint32_t entry = static_cast<std::uint32_t>(m_entryPoint);
+			for (int l = m_maxLevel; l > 0; l--)
+				entry = greedyClosest(query, entry, l);
+
+			std::vector<Result> results = searchLayer(query, entry, std::max(ef, k), 0, scratch);
+			if (results.size() > k)
+				results.resize(k);
+			return results;
+		}
+
+	private:
+		const float* vector(std::uint32_t id) const
+		{
+			return m_vectors.data() + static_cast<std::size_t>(id) * m_dimensions;
+		}
+
+		float distance(const float* query, std::uint32_t id) const
+		{
+			return 1.0f - dot(query, vector(id), m_dimensions);
+		}
+
+		std::uint32_t greedyClosest(const float* query, std::uint32_t entry, int level) const
+		{
+			float best = distance(query, entry);
+			for (bool improved = true; improved;)
+			{
+				improved = false;
+				for (auto neighbour : m_links[entry][level])
+				{
+					const float d = distance(query, neighbour);
+					if (d < best)
+					{
+						best = d;
+						entry = neighbour;
+						improved = true;
+					}
+				}
+			}
+			return entry;
+		}
+
+		// Best-first search of one layer, returns up to ef results closest first
+		std::vector<Result> searchLayer(const float* query, std::uint32_t entry, std::size_t ef, int level, Scratch& scratch) const
+		{
+			if (scratch.visited.size() < m_links.size())
+				scratch.visited.assign(m_links.size(), 0);
+			if (++scratch.stamp == 0)
+			{
+				std::fill(scratch.visited.begin(), scratch.visited.end(), 0);
+				scratch.stamp = 1;
+			}
+
+			std::priority_queue<Result, std::vector<Result>, std::greater<Result>> candidates;
+			std::priority_queue<Result> results;
+			const float d = distance(query, entry);
+			candidates.emplace(d, entry);
+			results.emplace(d, entry);
+			scratch.visited[entry] = scratch.stamp;
+
+			while (!candidates.empty())
+			{
+				const auto [candidateDistance, candidate] = candidates.top();
+				if (candidateDistance > results.top().first && results.size() >= ef)
+					break;
+				candidates.pop();
+
+				for (auto neighbour : m_links[candidate][level])
+				{
+					if (scratch.visited[neighbour] == scratch.stamp)
+						continue;
+					scratch.visited[neighbour] = scratch.stamp;
+
+					const float neighbourDistance = distance(query, neighbour);
+					if (results.size() < ef || neighbourDistance < results.top().first)
+					{
+						candidates.emplace(neighbourDistance, neighbour);
+						results.emplace(neighbourDistance, neighbour);
+						if (results.size() > ef)
+							results.pop();
+					}
+				}
+			}
+
+			std::vector<Result> sorted(results.size());
+			for (auto i = sorted.size(); i-- > 0; results.pop())
+				sorted[i] = results.top();
+			return sorted;
+		}
+
+		// Neighbour selection heuristic: skip candidates closer to an already selected neighbour than to the base
+		std::vector<std::uint32_t> selectNeighbours(const std::vector<Result>& candidates, std::size_t m) const
+		{
+			std::vector<std::uint32_t> selected;
+			selected.reserve(m);
+			for (const auto& [candidateDistance, candidate] : candidates)
+			{
+				if (selected.size() >= m)
+					break;
+				bool diverse = true;
+				for (auto s : selected)
+				{
+					if (distance(vector(candidate), s) < candidateDistance)
+					{
+						diverse = false;
+						break;
+					}
+				}
+				if (diverse)
+					selected.push_back(candidate);
+			}
+			return selected;
+		}
+
+		const std::vector<float>& m_vectors;
+		std::size_t m_dimensions;
+		std::size_t m_m;
+		std::size_t m_efConstruction;
+		double m_levelScale;
+		std::mt19937_64 m_generator;
+		std::vector<std::vector<std::vector<std::uint32_t>>> m_links;
+		long m_entryPoint = -1;
+		int m_maxLevel = 0;
+};
+}
+
+NeighbourSearchResult findCorrelatedNeighbours(
+		const ReturnMatrix& matrix,
+		const NeighbourSearchOptions& options)
+{
+	if (options.neighbours == 0 || options.dimensions == 0 || options.connections < 2)
+		throw std::invalid_argument("Neighbour search needs neighbours, dimensions and connections");
+
+	const std::size_t n = matrix.nbOfSeries();
+	const std::size_t t = matrix.nbOfSamples();
+	const std::size_t dimensions = options.dimensions;
+	NeighbourSearchResult result;
+
+	std::vector<std::size_t> rows;
+	for (std::size_t i = 0; i < n; i++)
+		if (matrix.counts[i] > 0)
+			rows.push_back(i);
+	if (rows.size() < 2)
+		return result;
+
+	// Gaussian random projections preserve dot products (Johnson-Lindenstrauss),
+	// embeddings are renormalized so the index works on cosine similarity
+	std::mt19937_64 generator(options.seed);
+	std::normal_distribution<float> gaussian(0.0f, 1.0f);
+	std::vector<float> projections(dimensions * t);
+	for (auto& value : projections)
+		value = gaussian(generator);
+
+	std::vector<float> embeddings(rows.size() * dimensions, 0.0f);
+	tools::parallelForEach(rows.size(), [&](std::size_t r) {
+		const float* row = matrix.row(rows[r]).data();
+		float* embedding = embeddings.data() + r * dimensions;
+		for (std::size_t p = 0; p < dimensions; p++)
+			embedding[p] = dot(projections.data() + p * t, row, t);
+		const float norm = std::sqrt(dot(embedding, embedding, dimensions));
+		if (norm > 0.0f)
+			for (std::size_t p = 0; p < dimensions; p++)
+				embedding[p] /= norm;
+	});
+
+	HnswIndex index(embeddings, dimensions, options.connections, options.efConstruction, options.seed);
+	{
+		HnswIndex::Scratch scratch;
+		for (std::size_t r = 0; r < rows.size(); r++)
+			index.insert(static_cast<std::uint32_t>(r), scratch);
+	}
+
+	// Every row is looked up twice, as is and negated, to find both signs of correlation
+	const std::size_t nbOfCandidates = options.neighbours * options.candidatesPerNeighbour;
+	const std::size_t ef = std::max(options.efSearch, nbOfCandidates);
+	std::vector<std::vector<Neighbour>> neighbours(rows.size());
+	std::vector<std::size_t> evaluated(rows.size(), 0);
+	const auto chunks = tools::splitIntoChunks(rows.size(), 16);
+	tools::parallelForEach(chunks.size(), [&](std::size_t c) {
+		HnswIndex::Scratch scratch;
+		std::vector<float> negated(dimensions);
+		std::vector<Neighbour> candidates;
+		for (std::size_t r = chunks[c].first; r < chunks[c].second; r++)
+		{
+			const float* embedding = embeddings.data() + r * dimensions;
+			for (std::size_t p = 0; p < dimensions; p++)
+				negated[p] = -embedding[p];
+
+			candidates.clear();
+			for (const auto& [d, j] : index.search(embedding, nbOfCandidates + 1, ef, scratch))
+				if (j != r)
+					candidates.push_back({j, 1.0f - d});
+			for (const auto& [d, j] : index.search(negated.data(), nbOfCandidates, ef, scratch))
+				if (j != r)
+					candidates.push_back({j, d - 1.0f});
+
+			// Both searches can return the same row, only its stronger estimate is kept
+			std::sort(candidates.begin(), candidates.end(), [](const Neighbour& x, const Neighbour& y) {
+				return x.row < y.row || (x.row == y.row && std::abs(x.correlation) > std::abs(y.correlation));
+			});
+			candidates.erase(std::unique(candidates.begin(), candidates.end(), [](const Neighbour& x, const Neighbour& y) {
+				return x.row == y.row;
+			}), candidates.end());
+
+			keepStrongest(candidates, nbOfCandidates);
+			for (auto& candidate : candidates)
+				candidate.correlation = dot(matrix.row(rows[r]).data(), matrix.row(rows[candidate.row]).data(), t);
+			evaluated[r] = candidates.size();
+			keepStrongest(candidates, options.neighbours);
+			neighbours[r] = candidates;
+		}
+	});
+	result.nbOfCandidates = std::accumulate(evaluated.begin(), evaluated.end(), std::size_t(0));
+
+	for (std::size_t r = 0; r < rows.size(); r++)
+	{
+		for (const auto& neighbour : neighbours[r])
+		{
+			const std::size_t j = rows[neighbour.row];
+			result.edges.push_back({
+				.a = std::min(rows[r], j),
+				.b = std::max(rows[r], j),
+				.correlation = neighbour.correlation
+			});
+		}
+	}
+	std::sort(result.edges.begin(), result.edges.end(), [](const auto& x, const auto& y) {
+		return x.a < y.a || (x.a == y.a && x.b < y.b);
+	});
+	result.edges.erase(std::unique(result.edges.begin(), result.edges.end(), [](const auto& x, const auto& y) {
+		return x.a == y.a && x.b == y.b;
+	}), result.edges.end());
+
+	// Recall against an exact brute-force search on evenly spaced sample rows
+	const std::size_t sampleSize = std::min(options.recallSampleSize, rows.size());
+	if (sampleSize == 0)
+		return result;
+	std::vector<std::size_t> found(sampleSize, 0);
+	std::vector<std::size_t> expected(sampleSize, 0);
+	tools::parallelForEach(sampleSize, [&](std::size_t s) {
+		const std::size_t r = s * rows.size() / sampleSize;
+		std::vector<Neighbour> exact;
+		exact.reserve(rows.size());
+		for (std::size_t j = 0; j < rows.size(); j++)
+			if (j != r)
+				exact.push_back({j, dot(matrix.row(rows[r]).data(), matrix.row(rows[j]).data(), t)});
+		keepStrongest(exact, options.neighbours);
+
+		expected[s] = exact.size();
+		for (const auto& e : exact)
+			for (const auto& a : neighbours[r])
+				found[s] += a.row == e.row;
+	});
+	const std::size_t totalExpected = std::accumulate(expected.begin(), expected.end(), std::size_t(0));
+	const std::size_t totalFound = std::accumulate(found.begin(), found.end(), std::size_t(0));
+	result.recall = totalExpected ? static_cast<float>(totalFound) / totalExpected : 1.0f;
+	return result;
+}
+}
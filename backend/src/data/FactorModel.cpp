@@ -0,0 +1,297 @@
+#include "data/factorModel.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace computations
+{
+namespace
+{
+// Column-major block of vectors, one std::vector per column
+using Block = std::vector<std::vector<double>>;
+
+double dot(const std::vector<double>& a, const std::vector<double>& b)
+{
+	double sum = 0.0;
+	for (std::size_t i = 0; i < a.size(); i++)
+		sum += a[i] * b[i];
+	return sum;
+}
+
+/**
+ *  Orthonormalizes the columns in place with modified Gram-Schmidt, run
+ *  twice for stability. Columns dependent on the previous ones become 0.
+ */
+void orthonormalize(Block& columns)
+{
+	for (std::size_t c = 0; c < columns.size(); c++)
+	{
+		auto& column = columns[c];
+		const double norm0 = std::sqrt(dot(column, column));
+		for (int pass = 0; pass < 2; pass++)
+		{
+			for (std::size_t p = 0; p < c; p++)
+			{
+				const double projection = dot(columns[p], column);
+				for (std::size_t i = 0; i < column.size(); i++)
+					column[i] -= projection * columns[p][i];
+			}
+		}
+		const double norm = std::sqrt(dot(column, column));
+		const double scale = norm > 1e-10 * std::max(norm0, 1e-30) ? 1.0 / norm : 0.0;
+		for (auto& value : column)
+			value *= scale;
+	}
+}
+
+// Y = X * B for the N x T matrix X and the T-long columns of B
+Block multiply(const ReturnMatrix& matrix, const Block& columns)
+{
+	const std::size_t nbOfSamples = matrix.nbOfSamples();
+	Block result(columns.size(), std::vector<double>(matrix.nbOfSeries(), 0.0));
+	tools::parallelForEach(columns.size(), [&](std::size_t c) {
+		for (std::size_t i = 0; i < matrix.nbOfSeries(); i++)
+		{
+			const float* row = matrix.values.data() + i * nbOfSamples;
+			double sum = 0.0;
+			for (std::size_t t = 0; t < nbOfSamples; t++)
+				sum += row[t] * columns[c][t];
+			result[c][i] = sum;
+		}
+	});
+	return result;
+}
+
+// Z = X^T * Q for the N x T matrix X and the N-long columns of Q
+Block multiplyTransposed(const ReturnMatrix& matrix, const Block& columns)
+{
+	const std::size_t nbOfSamples = matrix.nbOfSamples();
+	Block result(columns.size(), std::vector<double>(nbOfSamples, 0.0));
+	tools::parallelForEach(columns.size(), [&](std::size_t c) {
+		for (std::size_t i = 0; i < matrix.nbOfSeries(); i++)
+		{
+			const float* row = matrix.values.data() + i * nbOfSamples;
+			const double weight = columns[c][i];
+			if (weight == 0.0)
+				continue;
+			for (std::size_t t = 0; t < nbOfSamples; t++)
+				result[c][t] += weight * row[t];
+		}
+	});
+	return result;
+}
+
+/**
+ *  Eigendecomposition of a small symmetric matrix with cyclic Jacobi rotations
+ * @param a Row-major size x size matrix, destroyed
+ * @param size Matrix dimension
+ * @param vectors Receives the row-major eigenvectors, one per column
+ * @return Eigenvalues in the order of the columns of vectors
+ */
+std::vector<double> jacobiEigen(std::vector<double>& a, std::size_t size, std::vector<double>& vectors)
+{
+	vectors.assign(size * size, 0.0);
+	for (std::size_t i = 0; i < size; i++)
+		vectors[i * size + i] = 1.0;
+
+	for (int sweep = 0; sweep < 100; sweep++)
+	{
+		double offDiagonal = 0.0, diagonal = 0.0;
+		for (std::size_t p = 0; p < size; p++)
+		{
+			diagonal += a[p * size + p] * a[p * size + p];
+			for (std::size_t q = p + 1; q < size; q++)
+				offDiagonal += a[p * size + q] * a[p * size + q];
+		}
+		if (offDiagonal <= 1e-24 * diagonal || offDiagonal == 0.0)
+			break;
+
+		for (std::size_t p = 0; p < size; p++)
+		{
+			for (std::size_t q = p + 1; q < size; q++)
+			{
+				const double apq = a[p * size + q];
+				if (apq == 0.0)
+					continue;
+				const double theta = (a[q * size + q] - a[p * size + p]) / (2 * apq);
+				const double t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+				const double c = 1 / std::sqrt(t * t + 1);
+				const double s = t * c;
+				for (std::size_t k = 0; k < size; k++)
+				{
+					const double akp = a[k * size + p], akq = a[k * size + q];
+					a[k * size + p] = c * akp - s * akq;
+					a[k * size + q] = s * akp + c * akq;
+				}
+				for (std::size_t k = 0; k < size; k++)
+				{
+					const double apk = a[p * size + k], aqk = a[q * size + k];
+					a[p * size + k] = c * apk - s * aqk;
+					a[q * size + k] = s * apk + c * aqk;
+				}
+				for (std::size_t k = 0; k < size; k++)
+				{
+					const double vkp = vectors[k * size + p], vkq = vectors[k * size + q];
+					vectors[k * size + p] = c * vkp - s * vkq;
+					vectors[k * size + q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+
+	std::vector<double> values(size);
+	for (std::size_t i = 0; i < size; i++)
+		values[i] = a[i * size + i];
+	return values;
+}
+}
+
+FactorModel::FactorModel(
+		std::vector<float> loadings,
+		std::vector<float> eigenvalues,
+		std::vector<float> idiosyncraticVariances,
+		float totalVariance)
+	: m_loadings(std::move(loadings)),
+	  m_eigenvalues(std::move(eigenvalues)),
+	  m_idiosyncraticVariances(std::move(idiosyncraticVariances)),
+	  m_totalVariance(totalVariance)
+{
+	if (m_loadings.size() != m_eigenvalues.size() * m_idiosyncraticVariances.size())
+		throw std::invalid_argument("Every series needs one loading per factor");
+}
+
+std::span<const float> FactorModel::getLoadings(std::size_t i) const
+{
+	if (i >= nbOfSeries())
+		throw std::out_of_range("Series index out of range");
+	return {m_loadings.data() + i * nbOfFactors(), nbOfFactors()};
+}
+
+float FactorModel::getIdiosyncraticVariance(std::size_t i) const
+{
+	return m_idiosyncraticVariances.at(i);
+}
+
+float FactorModel::getExplainedVariance() const
+{
+	if (m_totalVariance <= 0)
+		return 0;
+	return std::accumulate(m_eigenvalues.begin(), m_eigenvalues.end(), 0.0f) / m_totalVariance;
+}
+
+float FactorModel::correlation(std::size_t i, std::size_t j) const
+{
+	const auto a = getLoadings(i);
+	const auto b = getLoadings(j);
+	if (i == j)
+		return std::inner_product(a.begin(), a.end(), a.begin(), 0.0f) + m_idiosyncraticVariances[i];
+	return std::inner_product(a.begin(), a.end(), b.begin(), 0.0f);
+}
+
+float FactorModel::residualCorrelation(std::size_t i, std::size_t j, float correlation, std::size_t nbOfRemovedFactors) const
+{
+	const auto a = getLoadings(i);
+	const auto b = getLoadings(j);
+	const std::size_t removed = std::min(nbOfRemovedFactors, nbOfFactors());
+
+	float common = 0, varianceA = 1, varianceB = 1;
+	for (std::size_t f = 0; f < removed; f++)
+	{
+		common += a[f] * b[f];
+		varianceA -= a[f] * a[f];
+		varianceB -= b[f] * b[f];
+	}
+	if (varianceA <= 1e-6f || varianceB <= 1e-6f)
+		return 0;
+	return std::clamp((correlation - common) / std::sqrt(varianceA * varianceB), -1.0f, 1.0f);
+}
+
+FactorModel computeFactorModel(const ReturnMatrix& matrix, const FactorModelOptions& options)
+{
+	const std::size_t nbOfSeries = matrix.nbOfSeries();
+	const std::size_t nbOfSamples = matrix.nbOfSamples();
+	const std::size_t rank = std::min({options.factors + options.oversampling, nbOfSeries, nbOfSamples});
+	const std::size_t nbOfFactors = std::min(options.factors, rank);
+
+	// Every observed row has unit norm, so the trace of the correlation matrix is the number of observed rows
+	const float totalVariance = static_cast<float>(std::count_if(
+			matrix.counts.begin(), matrix.counts.end(), [](std::size_t count) { return count > 0; }));
+	if (nbOfFactors == 0)
+	{
+		std::vector<float> idiosyncratic(nbOfSeries);
+		for (std::size_t i = 0; i < nbOfSeries; i++)
+			idiosyncratic[i] = matrix.counts[i] > 0 ? 1.0f : 0.0f;
+		return FactorModel({}, {}, std::move(idiosyncratic), totalVariance);
+	}
+
+	// Range finder: Q spans X * Omega for a Gaussian Omega, refined by power iterations on X X^T
+	std::mt19937_64 generator(options.seed);
+	std::normal_distribution<double> gaussian(0.0, 1.0);
+	Block omega(rank, std::vector<double>(nbOfSamples));
+	for (auto& column : omega)
+		for (auto& value : column)
+			value = gaussian(generator);
+
+	Block q = multiply(matrix, omega);
+	orthonormalize(q);
+	for (std::size_t iteration = 0; iteration < options.powerIterations; iteration++)
+	{
+		Block z = multiplyTransposed(matrix, q);
+		orthonormalize(z);
+		q = multiply(matrix, z);
+		orthonormalize(q);
+	}
+
+	// Small problem: B = Q^T X, eigenvectors of B B^T rotate Q into the eigenvectors of X X^T
+	const Block z = multiplyTransposed(matrix, q);
+	std::vector<double> gram(rank * rank);
+	for (std::size_t a = 0; a < rank; a++)
+		for (std::size_t b = a; b < rank; b++)
+			gram[a * rank + b] = gram[b * rank + a] = dot(z[a], z[b]);
+
+	std::vector<double> rotation;
+	const std::vector<double> eigenvalues = jacobiEigen(gram, rank, rotation);
+	std::vector<std::size_t> order(rank);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return eigenvalues[a] > eigenvalues[b]; });
+
+	std::vector<float> loadings(nbOfSeries * nbOfFactors, 0.0f);
+	std::vector<float> factorVariances(nbOfFactors);
+	for (std::size_t f = 0; f < nbOfFactors; f++)
+	{
+		const std::size_t column = order[f];
+		const double eigenvalue = std::max(eigenvalues[column], 0.0);
+		factorVariances[f] = static_cast<float>(eigenvalue);
+
+		// Eigenvector signs are arbitrary, the largest loading is made positive so models are comparable
+		std::vector<double> vector(nbOfSeries, 0.0);
+		for (std::size_t c = 0; c < rank; c++)
+		{
+			const double weight = rotation[c * rank + column];
+			for (std::size_t i = 0; i < nbOfSeries; i++)
+				vector[i] += weight * q[c][i];
+		}
+		const auto largest = std::max_element(vector.begin(), vector.end(),
+				[](double a, double b) { return std::abs(a) < std::abs(b); });
+		const double scale = std::sqrt(eigenvalue) * (*largest < 0 ? -1.0 : 1.0);
+		for (std::size_t i = 0; i < nbOfSeries; i++)
+			loadings[i * nbOfFactors + f] = static_cast<float>(vector[i] * scale);
+	}
+
+	std::vector<float> idiosyncratic(nbOfSeries, 0.0f);
+	for (std::size_t i = 0; i < nbOfSeries; i++)
+	{
+		if (matrix.counts[i] == 0)
+			continue;
+		float explained = 0;
+		for (std::size_t f = 0; f < nbOfFactors; f++)
+			explained += loadings[i * nbOfFactors + f] * loadings[i * nbOfFactors + f];
+		idiosyncratic[i] = std::max(0.0f, 1.0f - explained);
+	}
+	return FactorModel(std::move(loadings), std::move(factorVariances), std::move(idiosyncratic), totalVariance);
+}
+}
@@ -0,0 +1,320 @@
+#include "data/forceLayout.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+
+namespace computations
+{
+namespace
+{
+constexpr float ALPHA_MIN = 0.001f;
+// Squared distance below which forces stop growing, avoids explosions on near-coincident nodes
+constexpr float DISTANCE_MIN2 = 1.0f;
+constexpr int MAX_DEPTH = 24;
+
+struct Neighbour
+{
+	std::size_t node;
+	float weight;
+};
+
+/**
+ *  Octree over the node positions, every cell stores the number of nodes
+ *  below it and their center of mass
+ */
+class Octree
+{
+	public:
+		struct Cell
+		{
+			Position center;
+			float half = 0;           /**< Half of the cell width */
+			Position centerOfMass;
+			float mass = 0;
+			int firstChild = -1;      /**< Index of the first of 8 consecutive children, -1 for leaves */
+			std::size_t begin = 0;    /**< Range of the cell's nodes in the order array */
+			std::size_t end = 0;
+		};
+
+		void build(const std::vector<Position>& positions)
+		{
+			m_cells.clear();
+			m_order.resize(positions.size());
+			for (std::size_t i = 0; i < positions.size(); i++)
+				m_order[i] = i;
+			if (positions.empty())
+				return;
+
+			Position lo = positions[0], hi = positions[0];
+			for (const auto& p : positions)
+			{
+				lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+				hi = {std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+			}
+
+			Cell root;
+			root.center = {(lo.x + hi.x) / 2, (lo.y + hi.y) / 2, (lo.z + hi.z) / 2};
+			root.half = std::max({hi.x - lo.x, hi.y - lo.y, hi.z - lo.z}) / 2 + 1e-3f;
+			root.begin = 0;
+			root.end = positions.size();
+			m_cells.push_back(root);
+			split(0, positions, 0);
+		}
+
+		const std::vector<Cell>& cells() const { return m_cells; }
+		const std::vector<std::size_t>& order() const { return m_order; }
+
+	private:
+		void split(std::size_t index, const std::vector<Position>& positions, int depth)
+		{
+			Cell cell = m_cells[index];
+			cell.mass = static_cast<float>(cell.end - cell.begin);
+			Position sum;
+			for (std::size_t k = cell.begin; k < cell.end; k++)
+			{
+				sum.x += positions[m_order[k]].x;
+				sum.y += positions[m_order[k]].y;
+				sum.z += positions[m_order[k]].z;
+			}
+			cell.centerOfMass = {sum.x / cell.mass, sum.y / cell.mass, sum.z / cell.mass};
+
+			if (cell.end - cell.begin <= 1 || depth >= MAX_DEPTH)
+			{
+				m_cells[index] = cell;
+				return;
+			}
+
+			// Partitions the nodes by octant: x first, then y, then z
+			const auto first = m_order.begin();
+			auto byAxis = [&](std::size_t begin, std::size_t end, auto axis) {
+				return static_cast<std::size_t>(std::partition(first + begin, first + end, [&](std::size_t i) {
+					return axis(positions[i]) < axis(cell.center);
+				}) - first);
+			};
+			std::size_t bounds[9];
+			bounds[0] = cell.begin;
+			bounds[8] = cell.end;
+			bounds[4] = byAxis(bounds[0], bounds[8], [](const Position& p) { return p.x; });
+			for (int h = 0; h < 2; h++)
+			{
+				bounds[2 + 4 * h] = byAxis(bounds[4 * h], bounds[4 + 4 * h], [](const Position& p) { return p.y; });
+				for (int q = 0; q < 2; q++)
+				{
+					const int b = 4 * h + 2 * q;
+					bounds[b + 1] = byAxis(bounds[b], bounds[b + 2], [](const Position& p) { return p.z; });
+				}
+			}
+
+			cell.firstChild = static_cast<int>(m_cells.size());
+			m_cells[index] = cell;
+			m_cells.resize(m_cells.size() + 8);
+			const float quarter = cell.half / 2;
+			for (int octant = 0; octant < 8; octant++)
+			{
+				Cell& child = m_cells[cell.firstChild + octant];
+				child.center = {
+					cell.center.x + ((octant & 4) ? quarter : -quarter),
+					cell.center.y + ((octant & 2) ? quarter : -quarter),
+					cell.center.z + ((octant & 1) ? quarter : -quarter)
+				};
+				child.half = quarter;
+				child.begin = bounds[octant];
+				child.end = bounds[octant + 1];
+				if (child.begin < child.end)
+					split(cell.firstChild + octant, positions, depth + 1);
+			}
+		}
+
+		std::vector<Cell> m_cells;
+		std::vector<std::size_t> m_order;
+};
+
+bool contains(const Octree::Cell& cell, const Position& p)
+{
+	return std::abs(p.x - cell.center.x) <= cell.half
+		&& std::abs(p.y - cell.center.y) <= cell.half
+		&& std::abs(p.z - cell.center.z) <= cell.half;
+}
+
+std::vector<Position> initialPositions(
+		std::size_t nbOfNodes,
+		const std::vector<std::vector<Neighbour>>& adjacency,
+		const std::vector<std::optional<Position>>& previous,
+		const LayoutOptions& options)
+{
+	std::mt19937_64 generator(options.seed);
+	std::normal_distribution<float> gaussian(0.0f, 1.0f);
+	auto randomOffset = [&](float radius) {
+		Position p{gaussian(generator), gaussian(generator), gaussian(generator)};
+		const float norm = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z) + 1e-6f;
+		const float r = radius * std::cbrt(std::uniform_real_distribution<float>(0.0f, 1.0f)(generator)) / norm;
+		return Position{p.x * r, p.y * r, p.z * r};
+	};
+
+	std::vector<Position> positions(nbOfNodes);
+	const float radius = 10.0f * std::cbrt(static_cast<float>(nbOfNodes));
+	for (std::size_t i = 0; i < nbOfNodes; i++)
+	{
+		if (previous[i])
+		{
+			positions[i] = *previous[i];
+			continue;
+		}
+
+		// New nodes start next to the placed node they are most strongly linked to
+		const Neighbour* anchor = nullptr;
+		for (const auto& neighbour : adjacency[i])
+			if (previous[neighbour.node] && (!anchor || neighbour.weight > anchor->weight))
+				anchor = &neighbour;
+
+		const Position offset = randomOffset(anchor ? options.linkDistance / 2 : radius);
+		const Position base = anchor ? *previous[anchor->node] : Position{};
+		positions[i] = {base.x + offset.x, base.y + offset.y, base.z + offset.z};
+	}
+	return positions;
+}
+}
+
+std::vector<Position> computeForceLayout(
+		std::size_t nbOfNodes,
+		const std::vector<LayoutEdge>& edges,
+		const std::vector<std::optional<Position>>& previous,
+		const LayoutOptions& options)
+{
+	if (previous.size() != nbOfNodes)
+		throw std::invalid_argument("Every node needs a previous position slot");
+	if (nbOfNodes == 0)
+		return {};
+
+	std::vector<std::vector<Neighbour>> adjacency(nbOfNodes);
+	for (const auto& edge : edges)
+	{
+		if (edge.source >= nbOfNodes || edge.target >= nbOfNodes)
+			throw std::out_of_range("Layout edge refers to an unknown node");
+		if (edge.source == edge.target || !(edge.weight > 0))
+			continue;
+		const float weight = std::min(edge.weight, 1.0f);
+		adjacency[edge.source].push_back({edge.target, weight});
+		adjacency[edge.target].push_back({edge.source, weight});
+	}
+
+	std::vector<Position> positions = initialPositions(nbOfNodes, adjacency, previous, options);
+	std::vector<Position> velocities(nbOfNodes);
+
+	const std::size_t nbOfPlaced = std::count_if(previous.begin(), previous.end(), [](const auto& p) { return p.has_value(); });
+	const bool warmStart = 2 * nbOfPlaced >= nbOfNodes;
+	float alpha = warmStart ? options.warmStartAlpha : 1.0f;
+	const float alphaDecay = 1.0f - std::pow(ALPHA_MIN, 1.0f / std::max<std::size_t>(options.iterations, 1));
+	const float theta2 = options.theta * options.theta;
+
+	Octree tree;
+	const auto chunks = tools::splitIntoChunks(nbOfNodes, 64);
+	while (alpha > ALPHA_MIN)
+	{
+		alpha -= alpha * alphaDecay;
+		tree.build(positions);
+		const auto& cells = tree.cells();
+		const auto& order = tree.order();
+
+		// Every node only writes its own velocity, positions are read-only during a tick
+		tools::parallelForEach(chunks.size(), [&](std::size_t c) {
+			std::vector<std::size_t> stack;
+			for (std::size_t i = chunks[c].first; i < chunks[c].second; i++)
+			{
+				const Position p = positions[i];
+				Position v = velocities[i];
+
+				// Springs, split between both ends like d3's link force
+				for (const auto& neighbour : adjacency[i])
+				{
+					const Position q = positions[neighbour.node];
+					const float dx = q.x - p.x, dy = q.y - p.y, dz = q.z - p.z;
+					const float length = std::sqrt(dx * dx + dy * dy + dz * dz) + 1e-6f;
+					const float rest = options.linkDistance * (1.0f - 0.8f * neighbour.weight);
+					const std::size_t ci = adjacency[i].size(), cj = adjacency[neighbour.node].size();
+					const float strength = neighbour.weight / std::min(ci, cj);
+					const float share = static_cast<float>(cj) / (ci + cj);
+					const float k = (length - rest) / length * alpha * strength * share;
+					v.x += dx * k;
+					v.y += dy * k;
+					v.z += dz * k;
+				}
+
+				// Many-body repulsion through the octree
+				auto repel = [&](const Position& q, float mass, std::size_t other) {
+					float dx = q.x - p.x, dy = q.y - p.y, dz = q.z - p.z;
+					if (dx == 0 && dy == 0 && dz == 0)
+						dx = i < other ? 1e-3f : -1e-3f;
+					const float d2 = std::max(dx * dx + dy * dy + dz * dz, DISTANCE_MIN2);
+					const float k = options.charge * alpha * mass / d2;
+					v.x += dx * k;
+					v.y += dy * k;
+					v.z += dz * k;
+				};
+				stack.assign(1, 0);
+				while (!stack.empty())
+				{
+					const Octree::Cell& cell = cells[stack.back()];
+					stack.pop_back();
+					if (cell.mass == 0)
+						continue;
+
+					if (cell.firstChild < 0)
+					{
+						for (std::size_t k = cell.begin; k < cell.end; k++)
+							if (order[k] != i)
+								repel(positions[order[k]], 1.0f, order[k]);
+						continue;
+					}
+
+					const float dx = cell.centerOfMass.x - p.x, dy = cell.centerOfMass.y - p.y, dz = cell.centerOfMass.z - p.z;
+					const float width = 2 * cell.half;
+					if (!contains(cell, p) && width * width < theta2 * (dx * dx + dy * dy + dz * dz))
+					{
+						repel(cell.centerOfMass, cell.mass, nbOfNodes);
+						continue;
+					}
+					for (int octant = 0; octant < 8; octant++)
+						stack.push_back(cell.firstChild + octant);
+				}
+
+				// Weak pull towards the previous position, keeps reruns from drifting
+				if (warmStart && previous[i])
+				{
+					const float k = options.anchorStrength * alpha;
+					v.x += (previous[i]->x - p.x) * k;
+					v.y += (previous[i]->y - p.y) * k;
+					v.z += (previous[i]->z - p.z) * k;
+				}
+
+				velocities[i] = v;
+			}
+		});
+
+		Position mean;
+		double kineticEnergy = 0;
+		for (std::size_t i = 0; i < nbOfNodes; i++)
+		{
+			Position& v = velocities[i];
+			v = {v.x * (1 - options.velocityDecay), v.y * (1 - options.velocityDecay), v.z * (1 - options.velocityDecay)};
+			positions[i] = {positions[i].x + v.x, positions[i].y + v.y, positions[i].z + v.z};
+			mean = {mean.x + positions[i].x, mean.y + positions[i].y, mean.z + positions[i].z};
+			kineticEnergy += v.x * v.x + v.y * v.y + v.z * v.z;
+		}
+
+		// Keeps the layout centered on the origin like d3's center force
+		mean = {mean.x / nbOfNodes, mean.y / nbOfNodes, mean.z / nbOfNodes};
+		for (auto& position : positions)
+			position = {position.x - mean.x, position.y - mean.y, position.z - mean.z};
+
+		// Settled layouts stop early instead of cooling through the whole schedule
+		if (kineticEnergy / nbOfNodes < options.minKineticEnergy)
+			break;
+	}
+	return positions;
+}
+}
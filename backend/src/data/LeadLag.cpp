@@ -0,0 +1,222 @@
+#include "data/leadLag.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <stdexcept>
+
+namespace computations
+{
+namespace
+{
+using Complex = std::complex<float>;
+
+/**
+ *  Iterative radix-2 FFT of a fixed power of two size, twiddles and
+ *  bit reversal are computed once and shared by every transform
+ */
+class FFT
+{
+	public:
+		FFT(std::size_t size)
+			: m_size(size)
+			, m_twiddles(size / 2)
+			, m_reversed(size)
+		{
+			for (std::size_t k = 0; k < size / 2; k++)
+				m_twiddles[k] = std::polar(1.0, -2.0 * std::numbers::pi * k / size);
+
+			std::size_t bits = 0;
+			while ((std::size_t(1) << bits) < size)
+				bits++;
+			for (std::size_t i = 0; i < size; i++)
+			{
+				std::size_t r = 0;
+				for (std::size_t b = 0; b < bits; b++)
+					r |= ((i >> b) & 1) << (bits - 1 - b);
+				m_reversed[i] = r;
+			}
+		}
+
+		void forward(std::vector<Complex>& data) const { transform(data, false); }
+
+		// Unscaled inverse, the result is size times the actual inverse
+		void inverse(std::vector<Complex>& data) const { transform(data, true); }
+
+	private:
+		void transform(std::vector<Complex>& data, bool inverse) const
+		{
+			for (std::size_t i = 0; i < m_size; i++)
+				if (i < m_reversed[i])
+					std::swap(data[i], data[m_reversed[i]]);
+
+			for (std::size_t len = 2; len <= m_size; len <<= 1)
+			{
+				const std::size_t half = len / 2;
+				const std::size_t step = m_size / len;
+				for (std::size_t start = 0; start < m_size; start += len)
+				{
+					for (std::size_t k = 0; k < half; k++)
+					{
+						const std::complex<double>& w = m_twiddles[k * step];
+						const Complex twiddle(w.real(), inverse ? -w.imag() : w.imag());
+						const Complex odd = data[start + k + half] * twiddle;
+						data[start + k + half] = data[start + k] - odd;
+						data[start + k] += odd;
+					}
+				}
+			}
+		}
+
+		std::size_t m_size;
+		std::vector<std::complex<double>> m_twiddles;
+		std::vector<std::size_t> m_reversed;
+};
+
+/**
+ *  Two-sided standard normal critical value z with P(|Z| >= z) = alpha
+ */
+double normalCriticalValue(double alpha)
+{
+	double lo = 0.0, hi = 40.0;
+	for (int iteration = 0; iteration < 100; iteration++)
+	{
+		const double mid = (lo + hi) / 2;
+		if (std::erfc(mid / std::numbers::sqrt2) > alpha)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return hi;
+}
+
+/**
+ *  Lead/lag edges between every row i and each of its partners j > i,
+ *  every j > i when partners is null
+ */
+std::vector<LeadLagEdge> computeLeadLagOfPartners(
+		const ReturnMatrix& matrix,
+		const std::vector<std::vector<std::size_t>>* partners,
+		int maxLag,
+		float minCorrelation,
+		double pValue)
+{
+	if (maxLag <= 0)
+		throw std::invalid_argument("Maximum lag must be positive");
+	if (!(pValue > 0.0 && pValue < 1.0))
+		throw std::invalid_argument("P-value must be in (0, 1)");
+
+	const std::size_t n = matrix.nbOfSeries();
+	const std::size_t t = matrix.nbOfSamples();
+	std::vector<LeadLagEdge> edges;
+	if (n < 2 || t < 2)
+		return edges;
+
+	// Padding to at least 2T-1 keeps the circular correlation free of wrap-around
+	std::size_t size = 1;
+	while (size < 2 * t - 1)
+		size <<= 1;
+	const FFT fft(size);
+	const int lagLimit = std::min<int>(maxLag, static_cast<int>(t) - 1);
+	// Under independence every lag's correlation is about N(0, 1/overlap), the peak is taken over 2*lagLimit+1 lags
+	const double z = normalCriticalValue(pValue / (2 * lagLimit + 1));
+
+	std::vector<std::vector<Complex>> spectra(n);
+	tools::parallelForEach(n, [&](std::size_t i) {
+		spectra[i].assign(size, Complex(0.0f, 0.0f));
+		const auto row = matrix.row(i);
+		std::copy(row.begin(), row.end(), spectra[i].begin());
+		fft.forward(spectra[i]);
+	});
+
+	std::vector<std::vector<LeadLagEdge>> edgesPerRow(n);
+	tools::parallelForEach(n, [&](std::size_t i) {
+		if (matrix.counts[i] == 0)
+			return;
+
+		std::vector<Complex> cross(size);
+		const std::size_t nbOfPartners = partners ? (*partners)[i].size() : n - i - 1;
+		for (std::size_t p = 0; p < nbOfPartners; p++)
+		{
+			const std::size_t j = partners ? (*partners)[i][p] : i + 1 + p;
+			if (matrix.counts[j] == 0)
+				continue;
+
+			// conj(A) * B transforms to c(k) = sum_t a(t) b(t+k)
+			for (std::size_t f = 0; f < size; f++)
+				cross[f] = std::conj(spectra[i][f]) * spectra[j][f];
+			fft.inverse(cross);
+
+			int bestLag = 0;
+			float best = cross[0].real();
+			for (int lag = 1; lag <= lagLimit; lag++)
+			{
+				const float ahead = cross[lag].real();
+				const float behind = cross[size - lag].real();
+				if (std::abs(ahead) > std::abs(best))
+				{
+					best = ahead;
+					bestLag = lag;
+				}
+				if (std::abs(behind) > std::abs(best))
+				{
+					best = behind;
+					bestLag = -lag;
+				}
+			}
+
+			best /= static_cast<float>(size);
+			if (bestLag == 0)
+				continue;
+			const double overlap = static_cast<double>(std::min(matrix.counts[i], matrix.counts[j])) - std::abs(bestLag);
+			if (overlap < 3 || std::abs(best) < std::max<double>(minCorrelation, z / std::sqrt(overlap)))
+				continue;
+
+			// A positive lag means i at time t matches j at time t+lag, so i leads
+			edgesPerRow[i].push_back(bestLag > 0
+					? LeadLagEdge{.leader = i, .follower = j, .lag = bestLag, .correlation = best}
+					: LeadLagEdge{.leader = j, .follower = i, .lag = -bestLag, .correlation = best});
+		}
+	});
+
+	for (auto& rowEdges : edgesPerRow)
+		edges.insert(edges.end(), rowEdges.begin(), rowEdges.end());
+	return edges;
+}
+}
+
+std::vector<LeadLagEdge> computeLeadLag(
+		const ReturnMatrix& matrix,
+		int maxLag,
+		float minCorrelation,
+		double pValue)
+{
+	return computeLeadLagOfPartners(matrix, nullptr, maxLag, minCorrelation, pValue);
+}
+
+std::vector<LeadLagEdge> computeLeadLag(
+		const ReturnMatrix& matrix,
+		const std::vector<std::pair<std::size_t, std::size_t>>& pairs,
+		int maxLag,
+		float minCorrelation,
+		double pValue)
+{
+	const std::size_t n = matrix.nbOfSeries();
+	std::vector<std::vector<std::size_t>> partners(n);
+	for (const auto& [a, b] : pairs)
+	{
+		if (a >= n || b >= n)
+			throw std::out_of_range("Pair refers to an unknown series");
+		if (a != b)
+			partners[std::min(a, b)].push_back(std::max(a, b));
+	}
+	for (auto& rowPartners : partners)
+	{
+		std::sort(rowPartners.begin(), rowPartners.end());
+		rowPartners.erase(std::unique(rowPartners.begin(), rowPartners.end()), rowPartners.end());
+	}
+	return computeLeadLagOfPartners(matrix, &partners, maxLag, minCorrelation, pValue);
+}
+}
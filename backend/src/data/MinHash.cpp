@@ -0,0 +1,118 @@
+#include "data/minHash.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace computations
+{
+namespace
+{
+std::uint64_t fnv1a(const std::string& text)
+{
+	std::uint64_t hash = 0xcbf29ce484222325ull;
+	for (unsigned char c : text)
+	{
+		hash ^= c;
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+// splitmix64 finalizer, turns correlated inputs into independent looking hashes
+std::uint64_t mix(std::uint64_t x)
+{
+	x += 0x9e3779b97f4a7c15ull;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+	return x ^ (x >> 31);
+}
+}
+
+MinHashSketches computeMinHashSketches(
+		const std::vector<std::vector<std::string>>& sets,
+		std::size_t nbOfHashes,
+		std::uint64_t seed)
+{
+	MinHashSketches sketches;
+	sketches.nbOfHashes = nbOfHashes;
+	sketches.values.assign(sets.size() * nbOfHashes, std::numeric_limits<std::uint64_t>::max());
+	sketches.sizes.resize(sets.size());
+
+	std::vector<std::uint64_t> seeds(nbOfHashes);
+	for (std::size_t h = 0; h < nbOfHashes; h++)
+		seeds[h] = mix(seed + h);
+
+	tools::parallelForEach(sets.size(), [&](std::size_t i) {
+		std::uint64_t* sketch = sketches.values.data() + i * nbOfHashes;
+		for (const auto& item : sets[i])
+		{
+			const std::uint64_t base = fnv1a(item);
+			for (std::size_t h = 0; h < nbOfHashes; h++)
+				sketch[h] = std::min(sketch[h], mix(base ^ seeds[h]));
+		}
+		sketches.sizes[i] = sets[i].size();
+	});
+	return sketches;
+}
+
+float estimateJaccard(const MinHashSketches& sketches, std::size_t a, std::size_t b)
+{
+	if (sketches.sizes.at(a) == 0 || sketches.sizes.at(b) == 0 || sketches.nbOfHashes == 0)
+		return 0.0f;
+
+	const auto x = sketches.sketch(a);
+	const auto y = sketches.sketch(b);
+	std::size_t equal = 0;
+	for (std::size_t h = 0; h < sketches.nbOfHashes; h++)
+		equal += x[h] == y[h];
+	return static_cast<float>(equal) / sketches.nbOfHashes;
+}
+
+std::vector<SimilarityEdge> findSimilarSets(
+		const std::vector<std::vector<std::string>>& sets,
+		const MinHashOptions& options)
+{
+	if (options.nbOfBands == 0 || options.nbOfHashes % options.nbOfBands != 0)
+		throw std::invalid_argument("The number of bands must divide the number of hashes");
+
+	const MinHashSketches sketches = computeMinHashSketches(sets, options.nbOfHashes, options.seed);
+	const std::size_t rows = options.nbOfHashes / options.nbOfBands;
+
+	// Sets agreeing on every value of a band land in the same bucket of that band
+	std::vector<std::pair<std::size_t, std::size_t>> candidates;
+	std::unordered_map<std::uint64_t, std::vector<std::size_t>> buckets;
+	for (std::size_t band = 0; band < options.nbOfBands; band++)
+	{
+		buckets.clear();
+		for (std::size_t i = 0; i < sketches.nbOfSets(); i++)
+		{
+			if (sketches.sizes[i] == 0)
+				continue;
+			const auto sketch = sketches.sketch(i);
+			std::uint64_t key = mix(band);
+			for (std::size_t r = 0; r < rows; r++)
+				key = mix(key ^ sketch[band * rows + r]);
+			buckets[key].push_back(i);
+		}
+
+		for (const auto& [key, members] : buckets)
+			for (std::size_t m = 0; m < members.size(); m++)
+				for (std::size_t n = m + 1; n < members.size(); n++)
+					candidates.emplace_back(members[m], members[n]);
+	}
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+	std::vector<SimilarityEdge> edges;
+	for (const auto& [a, b] : candidates)
+	{
+		const float jaccard = estimateJaccard(sketches, a, b);
+		if (jaccard >= options.minSimilarity)
+			edges.push_back({.a = a, .b = b, .jaccard = jaccard});
+	}
+	return edges;
+}
+}
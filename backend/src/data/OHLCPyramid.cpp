@@ -0,0 +1,116 @@
+#include "data/ohlcPyramid.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+using namespace requests;
+
+namespace computations
+{
+namespace
+{
+constexpr std::size_t SECONDS_PER_DAY = 86400;
+// The epoch is a Thursday, 1970-01-05 is the first Monday
+constexpr std::size_t FIRST_MONDAY = 4 * SECONDS_PER_DAY;
+}
+
+std::size_t intervalToSeconds(const std::string& interval)
+{
+	std::size_t count = 0;
+	const char* first = interval.data();
+	const char* last = interval.data() + interval.size();
+	const auto [ptr, ec] = std::from_chars(first, last, count);
+	if (ec != std::errc() || count == 0 || ptr + 1 != last)
+		throw std::invalid_argument("Unsupported interval: " + interval);
+
+	switch (*ptr)
+	{
+		case 'm': return count * 60;
+		case 'h': return count * 3600;
+		case 'd': return count * 86400;
+		case 'w': return count * 7 * 86400;
+		default:
+			throw std::invalid_argument("Unsupported interval: " + interval);
+	}
+}
+
+std::vector<OHLC> resampleOHLC(
+		const std::vector<OHLC>& bars,
+		std::size_t intervalSeconds,
+		std::size_t sourceIntervalSeconds)
+{
+	if (intervalSeconds == 0)
+		throw std::invalid_argument("Interval must be positive");
+	if (sourceIntervalSeconds != 0 && intervalSeconds % sourceIntervalSeconds != 0)
+		throw std::invalid_argument("Interval is not a multiple of the source interval");
+
+	std::vector<OHLC> result;
+	if (bars.empty())
+		return result;
+
+	// Day multiples start on Mondays, shorter intervals on multiples since the epoch
+	const std::size_t offset = intervalSeconds % SECONDS_PER_DAY == 0 ? FIRST_MONDAY % intervalSeconds : 0;
+	const std::size_t expected = sourceIntervalSeconds != 0 ? intervalSeconds / sourceIntervalSeconds : 0;
+	std::size_t count = 0;
+	auto dropIfPartial = [&]() {
+		if (!result.empty() && count < expected)
+			result.pop_back();
+	};
+
+	result.reserve((bars.back().time - bars.front().time) / intervalSeconds + 1);
+	for (const auto& bar : bars)
+	{
+		const std::size_t bucket = bar.time - (bar.time + intervalSeconds - offset) % intervalSeconds;
+		if (result.empty() || result.back().time != bucket)
+		{
+			dropIfPartial();
+			result.push_back(bar);
+			result.back().time = bucket;
+			count = 1;
+			continue;
+		}
+
+		OHLC& current = result.back();
+		current.high = std::max(current.high, bar.high);
+		current.low = std::min(current.low, bar.low);
+		current.close = bar.close;
+		current.volume += bar.volume;
+		count++;
+	}
+	dropIfPartial();
+	return result;
+}
+
+OHLCPyramid::OHLCPyramid(std::vector<OHLC> bars, std::size_t intervalSeconds)
+	: m_baseInterval(intervalSeconds)
+{
+	if (intervalSeconds == 0)
+		throw std::invalid_argument("Interval must be positive");
+	m_levels.emplace(intervalSeconds, std::move(bars));
+}
+
+const std::vector<OHLC>& OHLCPyramid::getLevel(std::size_t intervalSeconds)
+{
+	if (auto it = m_levels.find(intervalSeconds); it != m_levels.end())
+		return it->second;
+
+	if (intervalSeconds % m_baseInterval != 0)
+		throw std::invalid_argument("Interval is not a multiple of the base interval");
+
+	// Coarser levels are cheaper to aggregate from, any divisor gives exact bars
+	auto source = m_levels.begin();
+	for (auto it = m_levels.begin(); it != m_levels.end() && it->first < intervalSeconds; it++)
+	{
+		if (intervalSeconds % it->first == 0)
+			source = it;
+	}
+
+	return m_levels.emplace(intervalSeconds, resampleOHLC(source->second, intervalSeconds, source->first)).first->second;
+}
+
+std::size_t OHLCPyramid::getBaseInterval() const
+{
+	return m_baseInterval;
+}
+}
@@ -0,0 +1,608 @@
+#include "data/query.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+using namespace table;
+
+namespace query
+{
+
+namespace
+{
+
+// Chunks smaller than this are not worth a thread of their own
+constexpr std::size_t MIN_CHUNK_SIZE = 1 << 15;
+// Independent accumulators per kernel so the compiler can keep them in vector registers
+constexpr std::size_t LANES = 8;
+
+struct AggregateState
+{
+	std::size_t count = 0;
+	double mean = 0.0;
+	double m2 = 0.0;
+	double min = std::numeric_limits<double>::infinity();
+	double max = -std::numeric_limits<double>::infinity();
+
+	void add(double x)
+	{
+		count++;
+		const double delta = x - mean;
+		mean += delta / count;
+		m2 += delta * (x - mean);
+		min = std::min(min, x);
+		max = std::max(max, x);
+	}
+
+	// Chan et al. pairwise update, keeps the result independent of the chunking
+	void merge(const AggregateState& other)
+	{
+		if (other.count == 0)
+			return;
+		if (count == 0)
+		{
+			*this = other;
+			return;
+		}
+		const double total = static_cast<double>(count + other.count);
+		const double delta = other.mean - mean;
+		mean += delta * other.count / total;
+		m2 += other.m2 + delta * delta * count * other.count / total;
+		count += other.count;
+		min = std::min(min, other.min);
+		max = std::max(max, other.max);
+	}
+
+	float result(Aggregate op) const
+	{
+		constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+		switch (op)
+		{
+			case Aggregate::Count:
+				return static_cast<float>(count);
+			case Aggregate::Sum:
+				return static_cast<float>(mean * count);
+			case Aggregate::Mean:
+				return count ? static_cast<float>(mean) : nan;
+			case Aggregate::Min:
+				return count ? static_cast<float>(min) : nan;
+			case Aggregate::Max:
+				return count ? static_cast<float>(max) : nan;
+			case Aggregate::StdDev:
+				// Sample standard deviation, matches what spreadsheets report
+				if (count == 0)
+					return nan;
+				return count > 1 ? static_cast<float>(std::sqrt(m2 / (count - 1))) : 0.0f;
+		}
+		return nan;
+	}
+};
+
+template<typename Fn>
+decltype(auto) withNumericColumn(const Table& t, const std::string& columnName, Fn&& fn)
+{
+	switch (t.getColumnDataType(columnName))
+	{
+		case DataType::Float:
+			return fn(t.getFloatColumnValues(columnName));
+		case DataType::Int:
+			return fn(t.getIntColumnValues(columnName));
+		default:
+			throw std::logic_error("Column is not numeric: " + columnName);
+	}
+}
+
+void checkRowCount(std::size_t size)
+{
+	if (size > std::numeric_limits<Selection::value_type>::max())
+		throw std::length_error("Table has too many rows for a selection");
+}
+
+// Row index of the j-th element visited by a kernel, either the row itself or a selected row
+struct AllRows
+{
+	std::uint32_t operator()(std::size_t j) const { return static_cast<std::uint32_t>(j); }
+};
+
+struct SelectedRows
+{
+	const Selection& selection;
+	std::uint32_t operator()(std::size_t j) const { return selection[j]; }
+};
+
+template<typename Fn>
+decltype(auto) withRows(const Selection* selection, Fn&& fn)
+{
+	if (selection)
+		return fn(SelectedRows{*selection});
+	return fn(AllRows{});
+}
+
+// Runs a kernel on every chunk of [0, size) in parallel and returns the per-chunk results in order
+template<typename Result, typename Kernel>
+std::vector<Result> runChunked(std::size_t size, Kernel&& kernel)
+{
+	const auto chunks = tools::splitIntoChunks(size, MIN_CHUNK_SIZE);
+	std::vector<Result> results(chunks.size());
+	tools::parallelForEach(chunks.size(), [&](std::size_t c) {
+		results[c] = kernel(chunks[c].first, chunks[c].second);
+	});
+	return results;
+}
+
+Selection concatenate(std::vector<Selection>&& parts)
+{
+	if (parts.size() == 1)
+		return std::move(parts[0]);
+
+	std::size_t total = 0;
+	for (const auto& part : parts)
+		total += part.size();
+
+	Selection result;
+	result.reserve(total);
+	for (const auto& part : parts)
+		result.insert(result.end(), part.begin(), part.end());
+	return result;
+}
+
+// Branchless compaction of a comparison mask into row indices
+template<typename RowFn>
+Selection compress(const std::vector<std::uint8_t>& mask, std::size_t begin, RowFn rowOf)
+{
+	Selection out(mask.size());
+	std::size_t k = 0;
+	for (std::size_t j = 0; j < mask.size(); j++)
+	{
+		out[k] = rowOf(begin + j);
+		k += mask[j];
+	}
+	out.resize(k);
+	return out;
+}
+
+template<typename T, typename RowFn>
+Selection filterChunk(
+		const std::vector<T>& values,
+		std::size_t begin,
+		std::size_t end,
+		Compare op,
+		float value,
+		RowFn rowOf)
+{
+	// Ints are compared in double so that large values are not rounded to float
+	using V = std::conditional_t<std::is_integral_v<T>, double, T>;
+	const V threshold = static_cast<V>(value);
+	std::vector<std::uint8_t> mask(end - begin);
+
+	auto fill = [&](auto cmp) {
+		for (std::size_t j = 0; j < mask.size(); j++)
+			mask[j] = cmp(static_cast<V>(values[rowOf(begin + j)]), threshold);
+	};
+	switch (op)
+	{
+		case Compare::Less:         fill(std::less<V>{}); break;
+		case Compare::LessEqual:    fill(std::less_equal<V>{}); break;
+		case Compare::Greater:      fill(std::greater<V>{}); break;
+		case Compare::GreaterEqual: fill(std::greater_equal<V>{}); break;
+		case Compare::Equal:        fill(std::equal_to<V>{}); break;
+		case Compare::NotEqual:     fill(std::not_equal_to<V>{}); break;
+	}
+	return compress(mask, begin, rowOf);
+}
+
+template<typename T, typename RowFn>
+AggregateState aggregateChunk(const std::vector<T>& values, std::size_t begin, std::size_t end, RowFn rowOf)
+{
+	AggregateState state;
+	if (begin >= end)
+		return state;
+
+	// Values are shifted by the first one so the sum of squares stays well conditioned
+	const double shift = static_cast<double>(values[rowOf(begin)]);
+	double sum[LANES] = {};
+	double sumSq[LANES] = {};
+	double lo[LANES];
+	double hi[LANES];
+	std::fill(lo, lo + LANES, shift);
+	std::fill(hi, hi + LANES, shift);
+
+	std::size_t j = begin;
+	for (; j + LANES <= end; j += LANES)
+	{
+		for (std::size_t l = 0; l < LANES; l++)
+		{
+			const double x = static_cast<double>(values[rowOf(j + l)]);
+			const double d = x - shift;
+			sum[l] += d;
+			sumSq[l] += d * d;
+			lo[l] = std::min(lo[l], x);
+			hi[l] = std::max(hi[l], x);
+		}
+	}
+	for (; j < end; j++)
+	{
+		const double x = static_cast<double>(values[rowOf(j)]);
+		const double d = x - shift;
+		sum[0] += d;
+		sumSq[0] += d * d;
+		lo[0] = std::min(lo[0], x);
+		hi[0] = std::max(hi[0], x);
+	}
+
+	double s = 0.0, ss = 0.0;
+	for (std::size_t l = 0; l < LANES; l++)
+	{
+		s += sum[l];
+		ss += sumSq[l];
+		state.min = std::min(state.min, lo[l]);
+		state.max = std::max(state.max, hi[l]);
+	}
+	const double n = static_cast<double>(end - begin);
+	state.count = end - begin;
+	state.mean = shift + s / n;
+	state.m2 = std::max(0.0, ss - s * s / n);
+	return state;
+}
+
+template<typename Key>
+struct Groups
+{
+	std::vector<Key> keys;
+	std::vector<AggregateState> states;
+};
+
+template<typename Key, typename KeyFn, typename T, typename RowFn>
+Groups<Key> groupChunk(
+		KeyFn keyOf,
+		const std::vector<T>& values,
+		std::size_t begin,
+		std::size_t end,
+		RowFn rowOf)
+{
+	Groups<Key> groups;
+	std::unordered_map<Key, std::size_t> index;
+	for (std::size_t j = begin; j < end; j++)
+	{
+		const std::uint32_t row = rowOf(j);
+		const auto [it, inserted] = index.try_emplace(keyOf(row), groups.keys.size());
+		if (inserted)
+		{
+			groups.keys.push_back(it->first);
+			groups.states.emplace_back();
+		}
+		groups.states[it->second].add(static_cast<double>(values[row]));
+	}
+	return groups;
+}
+
+// Hash group-by: every chunk builds its own table, tables are then merged in chunk order
+template<typename Key, typename KeyFn, typename T>
+Groups<Key> groupRows(KeyFn keyOf, const std::vector<T>& values, const Selection* selection)
+{
+	return withRows(selection, [&](auto rowOf) {
+		const std::size_t size = selection ? selection->size() : values.size();
+		auto parts = runChunked<Groups<Key>>(size, [&](std::size_t begin, std::size_t end) {
+			return groupChunk<Key>(keyOf, values, begin, end, rowOf);
+		});
+
+		Groups<Key> merged;
+		std::unordered_map<Key, std::size_t> index;
+		for (const auto& part : parts)
+		{
+			for (std::size_t g = 0; g < part.keys.size(); g++)
+			{
+				const auto [it, inserted] = index.try_emplace(part.keys[g], merged.keys.size());
+				if (inserted)
+				{
+					merged.keys.push_back(part.keys[g]);
+					merged.states.push_back(part.states[g]);
+				}
+				else
+				{
+					merged.states[it->second].merge(part.states[g]);
+				}
+			}
+		}
+		return merged;
+	});
+}
+
+std::int64_t floorDiv(std::int64_t a, std::int64_t b)
+{
+	const std::int64_t q = a / b;
+	return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's algorithm)
+std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d)
+{
+	y -= m <= 2;
+	const std::int64_t era = floorDiv(y, 400);
+	const unsigned yoe = static_cast<unsigned>(y - era * 400);
+	const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+	const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+void civilFromDays(std::int64_t z, std::int64_t& y, unsigned& m)
+{
+	z += 719468;
+	const std::int64_t era = floorDiv(z, 146097);
+	const unsigned doe = static_cast<unsigned>(z - era * 146097);
+	const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	const unsigned mp = (5 * doy + 2) / 153;
+	m = mp < 10 ? mp + 3 : mp - 9;
+	y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+std::int64_t parseTimestamp(const std::string& text)
+{
+	auto field = [&](std::size_t pos, std::size_t len) {
+		int value = 0;
+		const char* first = text.data() + pos;
+		const auto [ptr, ec] = std::from_chars(first, first + len, value);
+		if (ec != std::errc() || ptr != first + len)
+			throw std::invalid_argument("Unable to parse time value: " + text);
+		return value;
+	};
+
+	if (text.size() < 10 || text[4] != '-' || text[7] != '-')
+		throw std::invalid_argument("Unable to parse time value: " + text);
+
+	std::int64_t seconds = daysFromCivil(field(0, 4), field(5, 2), field(8, 2)) * 86400;
+	if (text.size() == 10)
+		return seconds;
+
+	if (text.size() < 19 || (text[10] != ' ' && text[10] != 'T') || text[13] != ':' || text[16] != ':')
+		throw std::invalid_argument("Unable to parse time value: " + text);
+
+	return seconds + field(11, 2) * 3600 + field(14, 2) * 60 + field(17, 2);
+}
+
+std::int64_t bucketStart(std::int64_t time, TimeUnit unit, int step)
+{
+	std::int64_t width = 0;
+	switch (unit)
+	{
+		case TimeUnit::Second: width = 1; break;
+		case TimeUnit::Minute: width = 60; break;
+		case TimeUnit::Hour:   width = 3600; break;
+		case TimeUnit::Day:    width = 86400; break;
+		case TimeUnit::Week:   width = 7 * 86400; break;
+		case TimeUnit::Month:
+		case TimeUnit::Year:
+		{
+			// Calendar buckets are counted in months since year 0 so that they start on the 1st
+			const std::int64_t months = unit == TimeUnit::Year ? 12 * step : step;
+			std::int64_t y;
+			unsigned m;
+			civilFromDays(floorDiv(time, 86400), y, m);
+			const std::int64_t bucket = floorDiv(y * 12 + (m - 1), months) * months;
+			const std::int64_t bucketYear = floorDiv(bucket, 12);
+			return daysFromCivil(bucketYear, static_cast<unsigned>(bucket - bucketYear * 12) + 1, 1) * 86400;
+		}
+	}
+	width *= step;
+	return floorDiv(time, width) * width;
+}
+
+}
+
+Selection filter(
+		const Table& t,
+		const std::string& columnName,
+		Compare op,
+		float value,
+		const Selection* selection)
+{
+	return withNumericColumn(t, columnName, [&](const auto& values) {
+		checkRowCount(values.size());
+		return withRows(selection, [&](auto rowOf) {
+			const std::size_t size = selection ? selection->size() : values.size();
+			return concatenate(runChunked<Selection>(size, [&](std::size_t begin, std::size_t end) {
+				return filterChunk(values, begin, end, op, value, rowOf);
+			}));
+		});
+	});
+}
+
+Selection filterEqual(
+		const Table& t,
+		const std::string& columnName,
+		const std::string& value,
+		const Selection* selection)
+{
+	const std::vector<std::string>& values = t.getStringColumnValues(columnName);
+	checkRowCount(values.size());
+	return withRows(selection, [&](auto rowOf) {
+		const std::size_t size = selection ? selection->size() : values.size();
+		return concatenate(runChunked<Selection>(size, [&](std::size_t begin, std::size_t end) {
+			std::vector<std::uint8_t> mask(end - begin);
+			for (std::size_t j = 0; j < mask.size(); j++)
+				mask[j] = values[rowOf(begin + j)] == value;
+			return compress(mask, begin, rowOf);
+		}));
+	});
+}
+
+Selection intersect(const Selection& a, const Selection& b)
+{
+	Selection result;
+	result.reserve(std::min(a.size(), b.size()));
+	std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+	return result;
+}
+
+Selection unite(const Selection& a, const Selection& b)
+{
+	Selection result;
+	result.reserve(a.size() + b.size());
+	std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+	return result;
+}
+
+float aggregate(
+		const Table& t,
+		const std::string& columnName,
+		Aggregate op,
+		const Selection* selection)
+{
+	return withNumericColumn(t, columnName, [&](const auto& values) {
+		return withRows(selection, [&](auto rowOf) {
+			const std::size_t size = selection ? selection->size() : values.size();
+			const auto parts = runChunked<AggregateState>(size, [&](std::size_t begin, std::size_t end) {
+				return aggregateChunk(values, begin, end, rowOf);
+			});
+			AggregateState total;
+			for (const auto& part : parts)
+				total.merge(part);
+			return total.result(op);
+		});
+	});
+}
+
+GroupedColumn groupBy(
+		const Table& t,
+		const std::string& keyColumnName,
+		const std::string& valueColumnName,
+		Aggregate op,
+		const Selection* selection)
+{
+	return withNumericColumn(t, valueColumnName, [&](const auto& values) {
+		GroupedColumn result;
+		auto collect = [&](const auto& groups, auto toString) {
+			result.keys.reserve(groups.keys.size());
+			result.values.reserve(groups.keys.size());
+			result.counts.reserve(groups.keys.size());
+			for (std::size_t g = 0; g < groups.keys.size(); g++)
+			{
+				result.keys.push_back(toString(groups.keys[g]));
+				result.values.push_back(groups.states[g].result(op));
+				result.counts.push_back(groups.states[g].count);
+			}
+		};
+
+		switch (t.getColumnDataType(keyColumnName))
+		{
+			case DataType::String:
+			{
+				const auto& keys = t.getStringColumnValues(keyColumnName);
+				if (keys.size() != values.size())
+					throw std::logic_error("Key and value columns have different sizes");
+				auto groups = groupRows<std::string_view>(
+						[&](std::uint32_t row) { return std::string_view(keys[row]); }, values, selection);
+				collect(groups, [](std::string_view key) { return std::string(key); });
+				break;
+			}
+			case DataType::Int:
+			{
+				const auto& keys = t.getIntColumnValues(keyColumnName);
+				if (keys.size() != values.size())
+					throw std::logic_error("Key and value columns have different sizes");
+				auto groups = groupRows<std::int64_t>(
+						[&](std::uint32_t row) { return static_cast<std::int64_t>(keys[row]); }, values, selection);
+				collect(groups, [](std::int64_t key) { return std::to_string(key); });
+				break;
+			}
+			default:
+				throw std::logic_error("Group-by key must be a string or int column: " + keyColumnName);
+		}
+		return result;
+	});
+}
+
+ResampledColumn resample(
+		const Table& t,
+		const std::string& timeColumnName,
+		const std::string& valueColumnName,
+		TimeUnit unit,
+		int step,
+		Aggregate op,
+		const Selection* selection)
+{
+	if (step <= 0)
+		throw std::invalid_argument("Resampling step must be positive");
+
+	std::vector<std::int64_t> buckets = toEpochSeconds(t, timeColumnName);
+	const auto chunks = tools::splitIntoChunks(buckets.size(), MIN_CHUNK_SIZE);
+	tools::parallelForEach(chunks.size(), [&](std::size_t c) {
+		for (std::size_t i = chunks[c].first; i < chunks[c].second; i++)
+			buckets[i] = bucketStart(buckets[i], unit, step);
+	});
+
+	return withNumericColumn(t, valueColumnName, [&](const auto& values) {
+		if (buckets.size() != values.size())
+			throw std::logic_error("Time and value columns have different sizes");
+
+		auto groups = groupRows<std::int64_t>(
+				[&](std::uint32_t row) { return buckets[row]; }, values, selection);
+
+		std::vector<std::size_t> order(groups.keys.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+			return groups.keys[a] < groups.keys[b];
+		});
+
+		ResampledColumn result;
+		result.bucketStarts.reserve(order.size());
+		result.values.reserve(order.size());
+		result.counts.reserve(order.size());
+		for (auto g : order)
+		{
+			result.bucketStarts.push_back(groups.keys[g]);
+			result.values.push_back(groups.states[g].result(op));
+			result.counts.push_back(groups.states[g].count);
+		}
+		return result;
+	});
+}
+
+std::vector<std::int64_t> toEpochSeconds(const Table& t, const std::string& columnName)
+{
+	std::vector<std::int64_t> result;
+	switch (t.getColumnDataType(columnName))
+	{
+		case DataType::Int:
+		{
+			const auto& values = t.getIntColumnValues(columnName);
+			result.assign(values.begin(), values.end());
+			break;
+		}
+		case DataType::Float:
+		{
+			// Floats only hold whole seconds up to 2^24, recent timestamps are rounded
+			const auto& values = t.getFloatColumnValues(columnName);
+			result.resize(values.size());
+			for (std::size_t i = 0; i < values.size(); i++)
+				result[i] = std::llround(static_cast<double>(values[i]));
+			break;
+		}
+		case DataType::String:
+		{
+			const auto& values = t.getStringColumnValues(columnName);
+			result.resize(values.size());
+			const auto chunks = tools::splitIntoChunks(values.size(), MIN_CHUNK_SIZE);
+			tools::parallelForEach(chunks.size(), [&](std::size_t c) {
+				for (std::size_t i = chunks[c].first; i < chunks[c].second; i++)
+					result[i] = parseTimestamp(values[i]);
+			});
+			break;
+		}
+		default:
+			throw std::logic_error("Column do not exist");
+	}
+	return result;
+}
+
+}
@@ -0,0 +1,96 @@
+#include "data/returnKernels.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace requests;
+
+namespace computations
+{
+namespace
+{
+// Series are handed to threads in groups of about this many values
+constexpr std::size_t MIN_VALUES_PER_CHUNK = 1 << 16;
+
+template<typename T, typename Price>
+SeriesBatch<T> gatherPrices(const std::vector<const std::vector<OHLC>*>& series, Price price)
+{
+	SeriesBatch<T> batch;
+	batch.offsets.resize(series.size() + 1);
+	for (std::size_t i = 0; i < series.size(); i++)
+		batch.offsets[i+1] = batch.offsets[i] + series[i]->size();
+
+	batch.values.resize(batch.offsets.back());
+	for (std::size_t i = 0; i < series.size(); i++)
+	{
+		T* out = batch.values.data() + batch.offsets[i];
+		const std::vector<OHLC>& bars = *series[i];
+		for (std::size_t j = 0; j < bars.size(); j++)
+			out[j] = price(bars[j]);
+	}
+	return batch;
+}
+}
+
+template<typename T>
+void computeLogReturns(std::span<const T> prices, std::span<T> out)
+{
+	if (prices.size() < 2)
+		return;
+	if (out.size() < prices.size() - 1)
+		throw std::invalid_argument("Output must hold one log return per pair of prices");
+
+	const T* p = prices.data();
+	T* r = out.data();
+	const std::size_t n = prices.size() - 1;
+	for (std::size_t i = 0; i < n; i++)
+		r[i] = fastLog(p[i+1] / p[i]);
+}
+
+template<typename T>
+SeriesBatch<T> batchMidPrices(const std::vector<const std::vector<OHLC>*>& series)
+{
+	return gatherPrices<T>(series, [](const OHLC& bar) {
+		return (static_cast<T>(bar.high) + static_cast<T>(bar.low)) * static_cast<T>(0.5);
+	});
+}
+
+template<typename T>
+SeriesBatch<T> batchClosePrices(const std::vector<const std::vector<OHLC>*>& series)
+{
+	return gatherPrices<T>(series, [](const OHLC& bar) {
+		return static_cast<T>(bar.close);
+	});
+}
+
+template<typename T>
+SeriesBatch<T> batchLogReturns(const SeriesBatch<T>& prices)
+{
+	SeriesBatch<T> returns;
+	returns.offsets.resize(prices.size() + 1);
+	for (std::size_t i = 0; i < prices.size(); i++)
+		returns.offsets[i+1] = returns.offsets[i] + std::max<std::size_t>(prices[i].size(), 1) - 1;
+	returns.values.resize(returns.offsets.back());
+
+	const std::size_t averageSize = prices.values.size() / std::max<std::size_t>(prices.size(), 1) + 1;
+	const auto chunks = tools::splitIntoChunks(prices.size(), MIN_VALUES_PER_CHUNK / averageSize + 1);
+	tools::parallelForEach(chunks.size(), [&](std::size_t c) {
+		for (std::size_t i = chunks[c].first; i < chunks[c].second; i++)
+		{
+			std::span<T> out(returns.values.data() + returns.offsets[i], returns.offsets[i+1] - returns.offsets[i]);
+			computeLogReturns<T>(prices[i], out);
+		}
+	});
+	return returns;
+}
+
+template void computeLogReturns<float>(std::span<const float>, std::span<float>);
+template void computeLogReturns<double>(std::span<const double>, std::span<double>);
+template SeriesBatch<float> batchMidPrices<float>(const std::vector<const std::vector<OHLC>*>&);
+template SeriesBatch<double> batchMidPrices<double>(const std::vector<const std::vector<OHLC>*>&);
+template SeriesBatch<float> batchClosePrices<float>(const std::vector<const std::vector<OHLC>*>&);
+template SeriesBatch<double> batchClosePrices<double>(const std::vector<const std::vector<OHLC>*>&);
+template SeriesBatch<float> batchLogReturns<float>(const SeriesBatch<float>&);
+template SeriesBatch<double> batchLogReturns<double>(const SeriesBatch<double>&);
+}
@@ -0,0 +1,50 @@
+#include "data/returnMatrix.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace computations
+{
+ReturnMatrix buildReturnMatrix(const std::vector<std::vector<std::pair<std::size_t, float>>>& returns)
+{
+	ReturnMatrix matrix;
+	for (const auto& series : returns)
+		for (const auto& [time, logReturn] : series)
+			matrix.times.push_back(time);
+	std::sort(matrix.times.begin(), matrix.times.end());
+	matrix.times.erase(std::unique(matrix.times.begin(), matrix.times.end()), matrix.times.end());
+
+	const std::size_t nbOfSamples = matrix.times.size();
+	matrix.values.assign(returns.size() * nbOfSamples, 0.0f);
+	matrix.counts.assign(returns.size(), 0);
+
+	tools::parallelForEach(returns.size(), [&](std::size_t i) {
+		const auto& series = returns[i];
+		if (series.empty())
+			return;
+
+		double mean = 0.0;
+		for (const auto& [time, logReturn] : series)
+			mean += logReturn;
+		mean /= series.size();
+
+		double sumSq = 0.0;
+		for (const auto& [time, logReturn] : series)
+			sumSq += (logReturn - mean) * (logReturn - mean);
+		if (!(sumSq > 0.0))
+			return;
+		const double scale = 1.0 / std::sqrt(sumSq);
+
+		float* row = matrix.values.data() + i * nbOfSamples;
+		auto t = matrix.times.begin();
+		for (const auto& [time, logReturn] : series)
+		{
+			t = std::lower_bound(t, matrix.times.end(), time);
+			row[t - matrix.times.begin()] = static_cast<float>((logReturn - mean) * scale);
+		}
+		matrix.counts[i] = series.size();
+	});
+	return matrix;
+}
+}
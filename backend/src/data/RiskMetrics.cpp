@@ -0,0 +1,130 @@
+#include "data/riskMetrics.hpp"
+#include "data/returnKernels.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+using namespace requests;
+
+namespace computations
+{
+RiskMetrics computeRiskMetrics(
+		const std::vector<OHLC>& bars,
+		const std::vector<std::pair<std::size_t, float>>& benchmark)
+{
+	RiskMetrics metrics;
+	if (bars.size() < 2)
+		return metrics;
+
+	// Central moments are updated online (Terriberry's extension of Welford's
+	// algorithm) so every bar is read exactly once
+	double n = 0, mean = 0, m2 = 0, m3 = 0, m4 = 0;
+	double downside = 0;
+	double volumeSum = 0, volumeReturnSum = 0;
+	double peak = bars[0].close, maxDrawdown = 0;
+	double nb = 0, meanR = 0, meanB = 0, coMoment = 0, m2B = 0;
+	std::size_t b = 0;
+
+	float prevAvgPrice = (bars[0].high + bars[0].low) * 0.5f;
+	for (std::size_t i = 1; i < bars.size(); i++)
+	{
+		const OHLC& bar = bars[i];
+		const float currAvgPrice = (bar.high + bar.low) * 0.5f;
+		const double r = fastLog(currAvgPrice / prevAvgPrice);
+		prevAvgPrice = currAvgPrice;
+
+		const double n1 = n;
+		n += 1;
+		const double delta = r - mean;
+		const double deltaN = delta / n;
+		const double deltaN2 = deltaN * deltaN;
+		const double term = delta * deltaN * n1;
+		mean += deltaN;
+		m4 += term * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m2 - 4 * deltaN * m3;
+		m3 += term * deltaN * (n - 2) - 3 * deltaN * m2;
+		m2 += term;
+
+		downside += r < 0 ? r * r : 0.0;
+		volumeSum += bar.volume;
+		volumeReturnSum += bar.volume * r;
+
+		peak = std::max(peak, static_cast<double>(bar.close));
+		if (peak > 0)
+			maxDrawdown = std::max(maxDrawdown, 1.0 - bar.close / peak);
+
+		while (b < benchmark.size() && benchmark[b].first < bar.time)
+			b++;
+		if (b < benchmark.size() && benchmark[b].first == bar.time)
+		{
+			const double x = benchmark[b].second;
+			nb += 1;
+			const double dR = r - meanR;
+			meanR += dR / nb;
+			const double dB = x - meanB;
+			meanB += dB / nb;
+			coMoment += dR * (x - meanB);
+			m2B += dB * (x - meanB);
+		}
+	}
+
+	metrics.nbOfReturns = static_cast<std::size_t>(n);
+	metrics.volatility = n > 1 ? std::sqrt(m2 / (n - 1)) : 0.0;
+	metrics.downsideDeviation = std::sqrt(downside / n);
+	metrics.maxDrawdown = maxDrawdown;
+	metrics.beta = m2B > 0 ? coMoment / m2B : 0.0;
+	// Population moments g1/g2 with the small-sample bias corrections G1/G2, as in Excel and pandas
+	if (m2 > 0 && n > 2)
+	{
+		const double g1 = std::sqrt(n) * m3 / std::pow(m2, 1.5);
+		metrics.skewness = g1 * std::sqrt(n * (n - 1)) / (n - 2);
+	}
+	if (m2 > 0 && n > 3)
+	{
+		const double g2 = n * m4 / (m2 * m2) - 3.0;
+		metrics.kurtosis = (n - 1) / ((n - 2) * (n - 3)) * ((n + 1) * g2 + 6);
+	}
+	metrics.volumeWeightedReturn = volumeSum > 0 ? volumeReturnSum / volumeSum : 0.0;
+	return metrics;
+}
+
+std::vector<RiskMetrics> computeRiskMetrics(
+		const std::vector<const std::vector<OHLC>*>& series,
+		const std::vector<std::pair<std::size_t, float>>& benchmark)
+{
+	std::vector<RiskMetrics> metrics(series.size());
+	tools::parallelForEach(series.size(), [&](std::size_t i) {
+		metrics[i] = computeRiskMetrics(*series[i], benchmark);
+	});
+	return metrics;
+}
+
+std::vector<std::pair<std::size_t, float>> computeMarketLogReturns(
+		const std::vector<std::vector<std::pair<std::size_t, float>>>& returns,
+		const std::vector<float>& weights)
+{
+	if (returns.size() != weights.size())
+		throw std::invalid_argument("Every series needs a weight");
+
+	std::map<std::size_t, std::pair<double, double>> sums;
+	for (std::size_t i = 0; i < returns.size(); i++)
+	{
+		if (!(weights[i] > 0))
+			continue;
+		for (const auto& [time, logReturn] : returns[i])
+		{
+			auto& [weightedSum, weightSum] = sums[time];
+			weightedSum += weights[i] * logReturn;
+			weightSum += weights[i];
+		}
+	}
+
+	std::vector<std::pair<std::size_t, float>> market;
+	market.reserve(sums.size());
+	for (const auto& [time, sum] : sums)
+		market.emplace_back(time, sum.first / sum.second);
+	return market;
+}
+}
@@ -3,30 +3,194 @@
 
 #include <nlohmann/json.hpp>
 
+#include <charconv>
+#include <cctype>
+#include <cmath>
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <string_view>
 
 namespace table
 {
 
 using json = nlohmann::json;
 
-bool isFloat(const std::string& segment) {
-    std::istringstream iss(segment);
-    float f;
-    iss >> f;
-	return iss.eof() && !iss.fail();
+namespace
+{
+// Smallest byte range worth parsing on a separate thread
+constexpr std::size_t MIN_CHUNK_BYTES = 1 << 20;
+
+/**
+ *  Columns parsed from one chunk of a file, indexed by a chunk-local column id
+ */
+struct ChunkColumns
+{
+	std::vector<std::string> names;
+	std::unordered_map<std::string, std::size_t> ids;
+	std::vector<std::vector<float>> floatColumns;
+	std::vector<std::vector<int>> intColumns;
+	std::vector<std::vector<std::string>> stringColumns;
+	int nbOfSamples = 0;
+
+	std::size_t columnId(const std::string& name)
+	{
+		const auto [it, inserted] = ids.try_emplace(name, names.size());
+		if (inserted)
+		{
+			names.push_back(name);
+			floatColumns.emplace_back();
+			intColumns.emplace_back();
+			stringColumns.emplace_back();
+		}
+		return it->second;
+	}
+};
+
+std::string readFile(const std::string& filePath)
+{
+	std::ifstream tableFile(filePath, std::ios::binary | std::ios::ate);
+	if (!tableFile.is_open())
+		throw std::runtime_error("Unable to read file with the table");
+
+	std::string content(static_cast<std::size_t>(tableFile.tellg()), '\0');
+	tableFile.seekg(0);
+	tableFile.read(content.data(), content.size());
+	return content;
 }
 
-bool isInt(const std::string& segment) {
-    std::istringstream iss(segment);
-    float f;
-    iss >> f;
-	return iss.eof() && !iss.fail();
+/**
+ *  Splits text into byte ranges that start right after a newline
+ * @return Vector of [begin, end) ranges covering the whole text in order
+ */
+std::vector<std::pair<std::size_t, std::size_t>> splitAtNewlines(std::string_view text)
+{
+	std::vector<std::pair<std::size_t, std::size_t>> chunks;
+	std::size_t begin = 0;
+	for (const auto& [first, last] : tools::splitIntoChunks(text.size(), MIN_CHUNK_BYTES))
+	{
+		if (last <= begin)
+			continue;
+		const std::size_t newline = last == text.size() ? std::string_view::npos : text.find('\n', last - 1);
+		const std::size_t end = newline == std::string_view::npos ? text.size() : newline + 1;
+		chunks.emplace_back(begin, end);
+		begin = end;
+	}
+	return chunks;
+}
+
+/**
+ *  Calls fn for every non-empty line, without its line break
+ */
+template <typename Fn>
+void forEachLine(std::string_view text, Fn&& fn)
+{
+	while (!text.empty())
+	{
+		const std::size_t end = text.find('\n');
+		std::string_view line = text.substr(0, end);
+		text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+		if (!line.empty())
+			fn(line);
+	}
+}
+
+/**
+ *  Parses a float cell, accepting what reading it from a stream does:
+ *  leading blanks and '+' are allowed, trailing characters, nan and inf are not
+ */
+bool parseFloat(std::string_view segment, float& value)
+{
+	while (!segment.empty() && std::isspace(static_cast<unsigned char>(segment.front())))
+		segment.remove_prefix(1);
+	if (segment.size() > 1 && segment.front() == '+' && segment[1] != '-')
+		segment.remove_prefix(1);
+
+	const char* end = segment.data() + segment.size();
+	const auto [ptr, error] = std::from_chars(segment.data(), end, value);
+	return error == std::errc() && ptr == end && std::isfinite(value);
+}
+
+/**
+ *  Appends the chunks in order to the table columns, every column is copied once
+ */
+void mergeChunks(
+		std::vector<ChunkColumns>& chunks,
+		std::unordered_map<std::string, std::vector<float>>& floatColumns,
+		std::unordered_map<std::string, std::vector<int>>& intColumns,
+		std::unordered_map<std::string, std::vector<std::string>>& stringColumns)
+{
+	// Columns are created and sized serially, then filled in parallel
+	struct Target
+	{
+		std::vector<float>* floats = nullptr;
+		std::vector<int>* ints = nullptr;
+		std::vector<std::string>* strings = nullptr;
+		std::vector<std::pair<std::size_t, std::size_t>> sources;  /**< (chunk, chunk-local column id) in order */
+	};
+	std::unordered_map<std::string, Target> targets;
+	std::vector<std::string> order;
+	for (std::size_t c = 0; c < chunks.size(); c++)
+	{
+		for (std::size_t id = 0; id < chunks[c].names.size(); id++)
+		{
+			const auto [it, inserted] = targets.try_emplace(chunks[c].names[id]);
+			if (inserted)
+				order.push_back(chunks[c].names[id]);
+			it->second.sources.emplace_back(c, id);
+		}
+	}
+
+	for (const auto& name : order)
+	{
+		Target& target = targets[name];
+		std::size_t nbOfFloats = 0, nbOfInts = 0, nbOfStrings = 0;
+		for (const auto& [c, id] : target.sources)
+		{
+			nbOfFloats += chunks[c].floatColumns[id].size();
+			nbOfInts += chunks[c].intColumns[id].size();
+			nbOfStrings += chunks[c].stringColumns[id].size();
+		}
+		// Only columns that received values of a type exist in that type's map
+		if (nbOfFloats > 0)
+		{
+			target.floats = &floatColumns[name];
+			target.floats->reserve(target.floats->size() + nbOfFloats);
+		}
+		if (nbOfInts > 0)
+		{
+			target.ints = &intColumns[name];
+			target.ints->reserve(target.ints->size() + nbOfInts);
+		}
+		if (nbOfStrings > 0)
+		{
+			target.strings = &stringColumns[name];
+			target.strings->reserve(target.strings->size() + nbOfStrings);
+		}
+	}
+
+	tools::parallelForEach(order.size(), [&](std::size_t n) {
+		const Target& target = targets.at(order[n]);
+		for (const auto& [c, id] : target.sources)
+		{
+			auto& chunk = chunks[c];
+			if (target.floats)
+				target.floats->insert(target.floats->end(), chunk.floatColumns[id].begin(), chunk.floatColumns[id].end());
+			if (target.ints)
+				target.ints->insert(target.ints->end(), chunk.intColumns[id].begin(), chunk.intColumns[id].end());
+			if (target.strings)
+				target.strings->insert(target.strings->end(),
+						std::make_move_iterator(chunk.stringColumns[id].begin()),
+						std::make_move_iterator(chunk.stringColumns[id].end()));
+		}
+	});
+}
 }
 
 Table::Table(const std::string& filePath)
+	: m_nbOfSamples(0)
+	, m_filePath(filePath)
 {
 	std::vector<std::string> subStrings;
 	tools:tools::parseString(filePath, subStrings, '.');
@@ -34,6 +198,10 @@ Table::Table(const std::string& filePath)
 	 || subStrings[subStrings.size()-1] == "JSON")
 	{
 		initFromJson(filePath);
+	}else if (subStrings[subStrings.size()-1] == "jsonl"
+	 || subStrings[subStrings.size()-1] == "JSONL")
+	{
+		initFromJsonLines(filePath);
 	}else if (subStrings[subStrings.size()-1] == "csv"
 	 || subStrings[subStrings.size()-1] == "CSV")
 	{
@@ -56,6 +224,8 @@ void Table::initFromJson(const std::string& filePath)
 	if (data.size() == 0)
 		return;
 
+	m_nbOfSamples = data.size();
+
 	for (auto& [key, value] : data[0].items())
 	{
 		m_columnNames.push_back(key);
@@ -80,38 +250,97 @@ void Table::initFromJson(const std::string& filePath)
 
 }
 
+void Table::initFromJsonLines(const std::string& filePath)
+{
+	const std::string content = readFile(filePath);
+	const std::string_view text = content;
+
+	// Column names come from the first object, like for a JSON array
+	const std::size_t firstLine = text.find_first_not_of(" \t\r\n");
+	if (firstLine != std::string_view::npos)
+	{
+		const json first = json::parse(text.substr(firstLine, text.find('\n', firstLine) - firstLine));
+		for (auto& [key, value] : first.items())
+			m_columnNames.push_back(key);
+	}
+
+	const auto ranges = splitAtNewlines(text);
+	std::vector<ChunkColumns> chunks(ranges.size());
+	tools::parallelForEach(ranges.size(), [&](std::size_t c) {
+		ChunkColumns& chunk = chunks[c];
+		forEachLine(text.substr(ranges[c].first, ranges[c].second - ranges[c].first), [&](std::string_view line) {
+			const json item = json::parse(line);
+			for (auto& [key, value] : item.items())
+			{
+				const std::size_t id = chunk.columnId(key);
+				if (value.is_number_float())
+				{
+					chunk.floatColumns[id].push_back(value);
+				}else if (value.is_number_integer())
+				{
+					chunk.intColumns[id].push_back(value);
+				}else
+				{
+					chunk.stringColumns[id].push_back(value);
+				}
+			}
+			chunk.nbOfSamples++;
+		});
+	});
+
+	for (const auto& chunk : chunks)
+		m_nbOfSamples += chunk.nbOfSamples;
+	mergeChunks(chunks, m_floatColumns, m_intColumns, m_stringColumns);
+}
+
 void Table::initFromCSV(const std::string& filePath)
 {
-	std::ifstream tableFile;
-	tableFile.open(filePath);
-	if (!tableFile.is_open())
-		throw std::runtime_error("Unable to read file with the table");
+	const std::string content = readFile(filePath);
+	std::string_view text = content;
 
-	std::string line;
-	getline(tableFile, line);
 	// We need to read column names
-	tools::parseString(line, m_columnNames, ',');
+	const std::size_t headerEnd = text.find('\n');
+	std::string header(text.substr(0, headerEnd));
+	if (!header.empty() && header.back() == '\r')
+		header.pop_back();
+	tools::parseString(header, m_columnNames, ',');
+	text.remove_prefix(headerEnd == std::string_view::npos ? text.size() : headerEnd + 1);
 
-	while (getline(tableFile, line))
-	{
-		std::vector<std::string> parsedLine;
-		tools::parseString(line, parsedLine, ',');
-		for (auto i = 0; i<parsedLine.size(); i++)
-		{
-			if (isFloat(parsedLine[i]))
-			{
-				m_floatColumns[m_columnNames[i]].push_back(std::stof(parsedLine[i]));
-			}else if (isInt(parsedLine[i]))
-			{
-				m_intColumns[m_columnNames[i]].push_back(std::stoi(parsedLine[i]));
-			}else
+	const auto ranges = splitAtNewlines(text);
+	std::vector<ChunkColumns> chunks(ranges.size());
+	tools::parallelForEach(ranges.size(), [&](std::size_t c) {
+		ChunkColumns& chunk = chunks[c];
+		// Repeated header names share one column, like in the map based layout
+		std::vector<std::size_t> ids;
+		ids.reserve(m_columnNames.size());
+		for (const auto& name : m_columnNames)
+			ids.push_back(chunk.columnId(name));
+
+		forEachLine(text.substr(ranges[c].first, ranges[c].second - ranges[c].first), [&](std::string_view line) {
+			std::size_t column = 0;
+			std::size_t begin = 0;
+			while (begin < line.size())
 			{
-				m_stringColumns[m_columnNames[i]].push_back(parsedLine[i]);
+				if (column >= m_columnNames.size())
+					throw std::runtime_error("Row has more values than the header");
+
+				const std::size_t end = std::min(line.find(',', begin), line.size());
+				const std::string_view segment = line.substr(begin, end - begin);
+				float value;
+				if (parseFloat(segment, value))
+					chunk.floatColumns[ids[column]].push_back(value);
+				else
+					chunk.stringColumns[ids[column]].emplace_back(segment);
+				column++;
+				begin = end + 1;
 			}
-		}
-	}
+			chunk.nbOfSamples++;
+		});
+	});
 
-	tableFile.close();
+	for (const auto& chunk : chunks)
+		m_nbOfSamples += chunk.nbOfSamples;
+	mergeChunks(chunks, m_floatColumns, m_intColumns, m_stringColumns);
 }
 
 
@@ -121,7 +350,7 @@ int Table::getNbOfSamples() const
 	return m_nbOfSamples;
 }
 
-DataType Table::getColumnDataType(const std::string& columnName)
+DataType Table::getColumnDataType(const std::string& columnName) const
 {
 	if (m_floatColumns.contains(columnName))
 		return DataType::Float;
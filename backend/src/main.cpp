@@ -23,7 +23,14 @@ std::string getCurrentTimestamp() {
 void runAnalysis() {
     try {
         std::cout << "[" << getCurrentTimestamp() << "] Starting log returns analysis...\n";
-        generateLogReturnsGraph("../../graphData/graphV2.json");
+        generateLogReturnsGraph("../../graphData/graphV2.json", GraphOptions{
+            .horizons = {"12h", "1d", "1w"},
+            .leadLag = true,
+            .layout = true,
+            .clustering = true,
+            .factorModel = true,
+            .holderSimilarity = true
+        });
         std::cout << "[" << getCurrentTimestamp() << "] Analysis completed successfully.\n";
     } catch (const std::exception& e) {
         std::cerr << "[" << getCurrentTimestamp() << "] Error during analysis: " << e.what() << std::endl;
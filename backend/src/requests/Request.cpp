@@ -4,6 +4,7 @@
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <cstdlib>
 
 namespace requests{
 // Callback function to write received data to a string
@@ -31,14 +32,23 @@ std::string paramsToUrlFormat(const nlohmann::json& params){
 	return urlFormatParams;
 }
 
+std::string apiBaseUrl(){
+	const char* url = std::getenv("TAPTOOLS_API_URL");
+	std::string baseUrl = url && *url ? url : Request::DEFAULT_BASE_URL;
+	if (baseUrl.back() != '/')
+		baseUrl += '/';
+	return baseUrl;
+}
+
 Request::Request(const std::string& endpoint){
 	std::string key = tools::readSingleLineFile("../.key"); // Path to the file with api Key
 	std::string keyParam = "x-api-key: "+key;
     m_headers = curl_slist_append(m_headers, keyParam.c_str());
-	m_url = "https://openapi.taptools.io/api/v1/" + endpoint;
+	m_url = apiBaseUrl() + endpoint;
 }
 
 Request::~Request(){
+	curl_slist_free_all(m_headers);
 }
 
 nlohmann::json Request::get(const nlohmann::json& params){
@@ -64,9 +74,9 @@ nlohmann::json Request::get(const nlohmann::json& params){
 	// Handle the response
 	if (res != CURLE_OK) {
 		std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
+		curl_easy_cleanup(m_curl);
 		throw std::runtime_error("Curl failed");
 	}
-	curl_slist_free_all(m_headers);
 	curl_easy_cleanup(m_curl);
 	return  nlohmann::json::parse(readBuffer);
 }
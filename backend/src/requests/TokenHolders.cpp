@@ -0,0 +1,67 @@
+#include "requests/tokenHolders.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace requests {
+
+TokenHolders::TokenHolders(const std::string& unit, int nbOfHolders)
+    : m_request("token/holders/top")
+    , m_unit(unit)
+    , m_nbOfHolders(nbOfHolders) {
+    if (nbOfHolders <= 0) {
+        throw std::invalid_argument("Number of holders must be positive");
+    }
+    update();
+}
+
+void TokenHolders::update() {
+    m_data.clear();
+
+    // The API serves at most MAX_HOLDERS_PER_PAGE holders per page
+    const int perPage = std::min(m_nbOfHolders, MAX_HOLDERS_PER_PAGE);
+
+    try {
+        for (int page = 1; static_cast<int>(m_data.size()) < m_nbOfHolders; page++) {
+            nlohmann::json params{
+                {"unit", m_unit},
+                {"page", page},
+                {"perPage", perPage}
+            };
+
+            const nlohmann::json result = m_request.get(params);
+
+            for (const auto& item : result) {
+                if (static_cast<int>(m_data.size()) >= m_nbOfHolders) {
+                    break;
+                }
+                m_data.push_back(Holder{
+                    .address = item["address"],
+                    .amount = item["amount"]
+                });
+            }
+
+            if (static_cast<int>(result.size()) < perPage) {
+                break;
+            }
+        }
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Failed to update holder data: " + std::string(e.what()));
+    }
+}
+
+const std::vector<struct Holder>& TokenHolders::getData() const {
+    return m_data;
+}
+
+std::vector<std::string> TokenHolders::getAddresses() const {
+    std::vector<std::string> addresses;
+    addresses.reserve(m_data.size());
+
+    for (const auto& holder : m_data) {
+        addresses.push_back(holder.address);
+    }
+    return addresses;
+}
+
+} // namespace requests
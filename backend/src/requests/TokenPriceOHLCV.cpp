@@ -1,12 +1,16 @@
 #include "requests/tokenPriceOHLCV.hpp"
+#include "data/returnKernels.hpp"
+#include "data/typedTable.hpp"
+
 #include <algorithm>
 #include <stdexcept>
 
 namespace requests {
 
-TokenOHLC::TokenOHLC(const std::string& unit)
+TokenOHLC::TokenOHLC(const std::string& unit, const std::string& interval)
     : m_request("token/ohlcv")
-    , m_unit(unit) {
+    , m_unit(unit)
+    , m_interval(interval) {
     update();
 }
 
@@ -16,22 +20,29 @@ void TokenOHLC::update() {
 
     nlohmann::json params{
         {"unit", m_unit},
-        {"interval", "12h"},
+        {"interval", m_interval},
         {"numIntervals", 1000}
     };
 
     try {
-        const nlohmann::json result = m_request.get(params);
-        m_data.reserve(result.size());
-
-        for (const auto& item : result) {
+        // Columns are read by schema position, a missing field throws instead of reading null
+        const auto bars = table::TypedTable<table::schemas::OHLCV>::fromJson(m_request.get(params));
+        const auto& times = bars.column<"time">();
+        const auto& volumes = bars.column<"volume">();
+        const auto& opens = bars.column<"open">();
+        const auto& highs = bars.column<"high">();
+        const auto& lows = bars.column<"low">();
+        const auto& closes = bars.column<"close">();
+        m_data.reserve(bars.size());
+
+        for (std::size_t i = 0; i < bars.size(); i++) {
             m_data.push_back(OHLC{
-                .time = item["time"],
-                .volume = item["volume"],
-                .open = item["open"],
-                .high = item["high"],
-                .low = item["low"],
-                .close = item["close"]
+                .time = static_cast<std::size_t>(times[i]),
+                .volume = volumes[i],
+                .open = opens[i],
+                .high = highs[i],
+                .low = lows[i],
+                .close = closes[i]
             });
         }
 
@@ -49,14 +60,14 @@ void TokenOHLC::calculateLogReturns() {
         return;
     }
 
+    const auto logReturns = computations::batchLogReturns(
+        computations::batchMidPrices<float>({&m_data}));
+
     float sumLogReturns = 0.0f;
     m_avgLogReturnsOverTime.reserve(m_data.size() - 1);
 
     for (size_t i = 1; i < m_data.size(); ++i) {
-        const float prevAvgPrice = (m_data[i-1].high + m_data[i-1].low) * 0.5f;
-        const float currAvgPrice = (m_data[i].high + m_data[i].low) * 0.5f;
-        
-        const float logReturn = std::log(currAvgPrice / prevAvgPrice);
+        const float logReturn = logReturns.values[i-1];
         sumLogReturns += logReturn;
 
         m_avgLogReturnsOverTime.emplace_back(m_data[i].time, logReturn);
@@ -73,4 +84,12 @@ float TokenOHLC::getAverageLogReturn() {
     return m_avgLogReturn;
 }
 
+const std::vector<OHLC>& TokenOHLC::getData() const {
+    return m_data;
+}
+
+const std::string& TokenOHLC::getInterval() const {
+    return m_interval;
+}
+
 } // namespace requests
@@ -1,4 +1,5 @@
 #include "requests/topLiquidityTokens.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 namespace requests {
@@ -15,23 +16,35 @@ TopLiquidityTokens::TopLiquidityTokens(int nbOfTokens)
 void TopLiquidityTokens::update() {
     m_data.clear();
 
-    nlohmann::json params{
-        {"page", 1},
-        {"perPage", m_nbOfTokens}
-    };
+    // The API serves at most MAX_TOKENS_PER_PAGE tokens per page
+    const int perPage = std::min(m_nbOfTokens, MAX_TOKENS_PER_PAGE);
 
     try {
-        const nlohmann::json result = m_request.get(params);
-        
-        for (const auto& item : result) {
-            m_data.emplace(
-                item["unit"].get<std::string>(),
-                Token{
-                    .ticker = item["ticker"],
-                    .liquidity = item["liquidity"],
-                    .price = item["price"]
+        for (int page = 1; static_cast<int>(m_data.size()) < m_nbOfTokens; page++) {
+            nlohmann::json params{
+                {"page", page},
+                {"perPage", perPage}
+            };
+
+            const nlohmann::json result = m_request.get(params);
+
+            for (const auto& item : result) {
+                if (static_cast<int>(m_data.size()) >= m_nbOfTokens) {
+                    break;
                 }
-            );
+                m_data.emplace(
+                    item["unit"].get<std::string>(),
+                    Token{
+                        .ticker = item["ticker"],
+                        .liquidity = item["liquidity"],
+                        .price = item["price"]
+                    }
+                );
+            }
+
+            if (static_cast<int>(result.size()) < perPage) {
+                break;
+            }
         }
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to update token data: " + std::string(e.what()));
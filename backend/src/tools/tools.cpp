@@ -1,5 +1,10 @@
 #include "tools/tools.hpp"
 #include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace tools {
 
@@ -41,4 +46,73 @@ std::string readSingleLineFile(const std::string& filePath)
     return line;
 }
 
+std::vector<std::pair<std::size_t, std::size_t>> splitIntoChunks(
+    std::size_t size,
+    std::size_t minChunkSize)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> chunks;
+    if (size == 0) {
+        return chunks;
+    }
+
+    const std::size_t nbOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t maxChunks = (size + std::max<std::size_t>(minChunkSize, 1) - 1)
+        / std::max<std::size_t>(minChunkSize, 1);
+    const std::size_t nbOfChunks = std::clamp<std::size_t>(maxChunks, 1, nbOfThreads);
+    const std::size_t chunkSize = (size + nbOfChunks - 1) / nbOfChunks;
+
+    chunks.reserve(nbOfChunks);
+    for (std::size_t begin = 0; begin < size; begin += chunkSize) {
+        chunks.emplace_back(begin, std::min(size, begin + chunkSize));
+    }
+    return chunks;
+}
+
+void parallelForEach(
+    std::size_t nbOfTasks,
+    const std::function<void(std::size_t)>& task)
+{
+    const std::size_t nbOfThreads = std::min<std::size_t>(
+        nbOfTasks, std::max(1u, std::thread::hardware_concurrency()));
+
+    if (nbOfThreads <= 1) {
+        for (std::size_t i = 0; i < nbOfTasks; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < nbOfTasks; i = next++) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = nbOfTasks;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nbOfThreads - 1);
+    for (std::size_t t = 1; t < nbOfThreads; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
 } // namespace tools